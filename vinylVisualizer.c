@@ -16,11 +16,30 @@
  * ===========================================================================================
  */
 
+#if defined(__linux__)
+#define _GNU_SOURCE                 /* CPU Affinity */
+#endif
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
 #include <stdbool.h>
 #include <string.h>         /* for memset */
+#include <stdarg.h>
+#include <stdatomic.h>      /* Lock-Free Meter Readings */
+#include <time.h>           /* clock_gettime for Benchmarks */
+#include <pthread.h>        /* Parallel Frame Export */
+#include <sched.h>          /* Real-Time Priorities, CPU Sets */
+#include <sys/stat.h>       /* mkdir */
+#include <errno.h>
+#include <stdint.h>
+#include <fcntl.h>          /* open */
+#include <sys/mman.h>       /* Memory-Mapped Overview Sidecars */
+#include <zlib.h>           /* PNG Compression */
+#if defined(__SSE__)
+#include <xmmintrin.h>      /* SIMD Gain Application */
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
 #include <ncurses.h>        /* This library is for getting input without hitting return */
 #include <portaudio.h>
 #include <sndfile.h>         
@@ -30,6 +49,7 @@
 #ifdef __MACOSX_CORE__
 #include <GLUT/glut.h>
 #else
+#define GL_GLEXT_PROTOTYPES     /* Buffer Object Entry Points */
 #include <GL/gl.h>
 #include <GL/glu.h>
 #include <GL/glut.h>
@@ -55,6 +75,11 @@
 #define FORMAT                  paFloat32
 #define SAMPLE                  float
 #define SRC_RATIO_INCREMENT     0.01
+#define CALIBRATE_BUDGET        0.25    // Default Share of the Block Deadline for the Resampler
+#define CALIBRATE_RATIO         0.5     // Fastest the Motor Runs, Where Sinc Costs the Most
+#define CALIBRATE_BLOCKS        64
+#define CALIBRATE_INPUT_FRAMES  (FRAMES_PER_BUFFER * 2 + 2)     // Covers CALIBRATE_RATIO
+#define CALIBRATE_FILE          ".vinylVisualizer-src"  // In $HOME
 #define FILTER_CUTOFF_INCREMENT 100 //hz 
 #define RESONANCE_INCREMENT     1   // Q Factor
 #define PI                      3.14159265358979323846264338327950288
@@ -65,7 +90,623 @@
 #define ROTATION_INCR           .75f
 #define INIT_WIDTH              1280
 #define INIT_HEIGHT             720
+#define RING_MAX_SEGMENTS       8192    // Vertex Buffer Capacity per Ring
+#define RING_RADIUS             3
+#define RING_DEPTH              0.5f    // Radial Displacement per Unit Sample
+
+/* Per-Channel Visual History */
+#define VISUAL_HISTORY          8192    // Frames per Channel, Power of Two
+#define RING_MODE_MIX           0       // Channel Mean on Both Rings
+#define RING_MODE_LR            1       // Left Outer, Right Inner
+#define RING_MODE_MS            2       // Mid Outer, Side Inner
+#define RING_MODE_DECKS         3       // Deck A Outer, Deck B Inner, Only With Two Decks
+#define RING_MODE_COUNT         4
+
+/* Persistence Trails */
+#define TRAIL_DEFAULT_RINGS     64      // Override With --trail
+#define TRAIL_MAX_RINGS         128
+#define TRAIL_SPREAD            0.015f  // Radius Growth per Frame of Age
+#define TRAIL_OPACITY           0.6f
+#define TRAIL_STAMP_WRAP        65536   // Frame Stamps Wrap Here to Stay Exact in a Float
+#define TRAIL_VERTEX_FLOATS     8       // xyz, rgba, Stamp
+
+/* Waveform Overview Pyramid */
+#define PYRAMID_MAGIC           "VVPYR01"   // 8 Bytes With the Terminator
+#define PYRAMID_EXTENSION       ".vvpyr"    // Sidecar Next to the Audio File
+#define PYRAMID_BASE_SHIFT      8           // Finest Level Bins 2^8 Frames
+#define PYRAMID_MAX_LEVELS      48
+#define PYRAMID_READ_FRAMES     65536
+#define OVERVIEW_HEIGHT         0.12f       // Strip Height, Fraction of the Window
+#define OVERVIEW_MARGIN         0.02f
+#define OVERVIEW_FAILED         0
+#define OVERVIEW_BUILDING       1
+#define OVERVIEW_READY          2
+
+/* Playback Cache */
+#define CACHE_FRAMES            (1 << 18)   // Frames per Window, Power of Two (~6s at 44.1kHz)
+#define CACHE_AHEAD             (CACHE_FRAMES / 2)  // In the Direction of Travel
+#define CACHE_BEHIND            (CACHE_FRAMES / 4)  // Kept Behind the Playhead for Seeks and Reversals
+#define CACHE_READ_FRAMES       16384       // Frames per Disk Read
+#define CACHE_PREFETCH_FRAMES   8192        // Decoded Before a Far Seek is Published
+#define CACHE_POLL_US           1000
+#define SEEK_SMALL_SECONDS      1.0
+#define SEEK_LARGE_SECONDS      10.0
+
+/* Event Log, Filled by the Audio Thread */
+#define LOG_RING_SIZE           256         // Records, Power of Two
+#define LOG_POLL_MS             50
+#define LOG_DEFAULT_FILE        "vinylVisualizer.log"
+#define LOG_SRC_ERROR           0           // Detail: Error << 16 | Frames Silenced
+#define LOG_CACHE_UNDERRUN      1           // Detail: Frames Requested
+#define LOG_OUTPUT_UNDERFLOW    2
+#define LOG_OUTPUT_OVERFLOW     3
+#define LOG_SRC_DOWNGRADE       4           // Detail: Converter << 8 | Callback p99 Percent
+#define LOG_SRC_UPGRADE         5
+#define LOG_PRODUCERS           2           // Audio Thread and the Second Deck's Worker
+
+/* Parameter Automation, Every Control Change Stamped With its Output Frame */
+#define AUTOMATION_RING_SIZE    1024        // Changes in Flight Each Way, Power of Two
+#define AUTO_RATIO              0           // Controls, Named in automationNames
+#define AUTO_DIRECTION          1
+#define AUTO_MOTOR              2
+#define AUTO_LPF_ON             3
+#define AUTO_LPF_FREQ           4
+#define AUTO_LPF_RES            5
+#define AUTO_HPF_ON             6
+#define AUTO_HPF_FREQ           7
+#define AUTO_HPF_RES            8
+#define AUTO_VOLUME             9
+#define AUTO_SCRATCH            10          // Hand on (1) or off (0) the Record
+#define AUTO_SCRATCH_SPEED      11
+#define AUTO_SEEK               12          // File Frame
+#define AUTO_CROSSFADER         13          // Mixer, not a Deck
+#define AUTO_CONTROLS           14
+
+/* Two Decks */
+#define CROSSFADER_CENTER       0.5         // 0 is All Deck A, 1 All Deck B
+#define CROSSFADER_INCREMENT    0.05
+#define DECK_WAIT_MS            2           // Idle Worker Rechecks at Least This Often
+
+/* Resampler Governor, Trades Quality for Headroom Under Load */
+#define GOVERNOR_LEVELS         5           // Best, Medium, Fastest, Linear, Zero Order Hold
+#define GOVERNOR_WINDOW         256         // Callbacks in the Moving Percentile
+#define GOVERNOR_BINS           200         // 1% of the Deadline Each, the Last Catches Overruns
+#define GOVERNOR_PERCENTILE     0.99
+#define GOVERNOR_HIGH           70          // p99 Percent of the Deadline That Steps Down
+#define GOVERNOR_LOW            30          // p99 Percent That Counts as Headroom
+#define GOVERNOR_CHECK_BLOCKS   16          // Callbacks Between Decisions
+#define GOVERNOR_UP_BLOCKS      512         // Headroom Must Last This Long Before Stepping Up
+#define GOVERNOR_PRIME_FRAMES   128         // History Fed to a Fresh Converter Before its Crossfade
+#define GOVERNOR_LOOKAHEAD      1024        // Input Offered Past That, Sinc Buffers Ahead
+
+/* Real-Time Setup */
+#define RT_DEFAULT_PRIORITY     70          // With --sched fifo|rr
+#define RT_WAIT_MS              500         // For the First Callback to Name its Thread
+#define RT_THREAD_AUDIO         0           // Thread Roles for --affinity
+#define RT_THREAD_READER        1
+#define RT_THREAD_ANALYSIS      2
+#define RT_THREAD_RENDER        3           // GLUT Thread and Export Workers
+#define RT_THREAD_COUNT         4
+
+/* Platter Speed and Scratching */
+#define PLATTER_MAX_SPEED       6.0         // Times Normal, Bounded by src_inBuffer
+#define PLATTER_MIN_SPEED       (1.0 / 256) // libsamplerate's Largest Ratio, Slower is Stopped
+#define PLATTER_MOTOR_ON        0
+#define PLATTER_MOTOR_BRAKE     1           // Switched Off, Braked to a Stop
+#define PLATTER_MOTOR_OFF       2           // Power Cut, Coasts Down on Bearing Friction
+#define PLATTER_START_SECONDS   0.7         // Motor Torque, Standstill to Normal Speed
+#define PLATTER_BRAKE_SECONDS   0.4         // Normal Speed to Standstill
+#define PLATTER_COAST_SECONDS   6.0
+#define PLATTER_HAND_SECONDS    0.02        // A Hand's Torque, per 1x of Speed Change
+#define PLATTER_SUBBLOCK        64          // Frames per Resampler Call While Speed Changes
+#define BYPASS_TOLERANCE        1e-9        // Speed Keys Step Back to 1.00 With Rounding Error
+#define SCRATCH_TURN_SECONDS    1.8         // One Revolution at 33 1/3 RPM
+#define SCRATCH_SMOOTHING       0.5         // Weight of Each New Mouse Velocity
+#define SCRATCH_HOLD_SECONDS    0.05        // No Motion for This Long Means the Hand Stopped
+
+/* Frame Pacing */
+#define FRAME_RATE_CAP          60      // Default, Override With --max-fps
+#define FRAME_STATS_INTERVAL    0.5     // Seconds Between Render Readouts
+#define VSYNC_SWAP_FRACTION     0.3     // Swap Blocking This Much of a Frame Means VSync
+
+/* GPU Frame Timing, Core Name on Linux, EXT on OS X's Legacy Context */
+#if defined(GL_TIME_ELAPSED)
+#define GPU_TIMER_TARGET        GL_TIME_ELAPSED
+#define GPU_TIMER_RESULT        glGetQueryObjectui64v
+typedef GLuint64 gpuTimerValue;
+#elif defined(GL_TIME_ELAPSED_EXT)
+#define GPU_TIMER_TARGET        GL_TIME_ELAPSED_EXT
+#define GPU_TIMER_RESULT        glGetQueryObjectui64vEXT
+typedef GLuint64EXT gpuTimerValue;
+#endif
 
+/* Offscreen Export */
+#define EXPORT_FPS              30
+#define EXPORT_BATCH_FRAMES     64      // Video Frames Snapshotted Before Rendering in Parallel
+#define EXPORT_MAX_THREADS      64
+#define CAMERA_DISTANCE         10.0f   // Matches gluLookAt in reshapeFunc
+#define CAMERA_FOVY             45.0f   // Matches gluPerspective in reshapeFunc
+
+/* Batch Analysis */
+#define ANALYZE_MAX_THREADS     64
+#define ANALYZE_CHUNK_HOPS      100     // Loudness Hops per Chunk Task (10s)
+#define ANALYZE_PREROLL_HOPS    (LOUDNESS_MOMENTARY_HOPS - 1)   // Re-Read so Gating Blocks Tile Across Chunks
+#define ANALYZE_FFT_SIZE        1024
+#define ANALYZE_FFT_HOP         512     // Onset Envelope at ~86Hz for 44.1kHz
+#define ANALYZE_MIN_BPM         60.0
+#define ANALYZE_MAX_BPM         200.0
+#define ANALYZE_BPM_PRIOR       120.0   // Centre of the Log-Scale Tempo Weighting
+#define ANALYZE_MIN_PULSE       0.1     // Onset Autocorrelation Below This is No Beat
+
+/* Benchmark Sweep */
+#define BENCH_MIN_FRAMES        64
+#define BENCH_MAX_FRAMES        4096
+#define BENCH_MIN_RATIO         0.5     // Smallest Swept SRC Ratio
+#define BENCH_MAX_INPUT         (BENCH_MAX_FRAMES * 2 + 2)  // Input Frames it Reads per Call
+#define BENCH_TRIAL_SECONDS     0.002   // Each Trial Repeats a Kernel at Least This Long
+#define BENCH_TRIALS            5       // The Fastest Trial is Reported
+#define BENCH_CLOCK_MULTIPLIES  (1 << 24)   // Dependent 64-bit Multiplies Timed for the Core Clock
+#define BENCH_MULTIPLY_CYCLES   3       // Their Latency on Current x86 and Apple Cores
+
+/* Golden-Output Regression */
+#define GOLDEN_SECONDS          5.0     // Rendered per Scenario
+#define GOLDEN_MIN_SNR          100.0   // dB, Override With --snr
+#define GOLDEN_MAX_PEAK_ERROR   -80.0   // dBFS, Override With --peak-error
+#define GOLDEN_INPUT            "input.wav" // CACHE_FRAMES of Stereo, Generated by the First --record
+
+/* EBU R128 Loudness Meter */
+#define LOUDNESS_HOP_MS         100     // Gating Block Hop (75% Overlap of 400ms)
+#define LOUDNESS_MOMENTARY_HOPS 4       // 400ms Momentary Window
+#define LOUDNESS_SHORTTERM_HOPS 30      // 3s Short-Term Window
+#define LOUDNESS_ABS_GATE       -70.0   // LUFS
+#define LOUDNESS_REL_GATE       -10.0   // LU
+#define LOUDNESS_HIST_BINS      1000    // 0.1 LU Bins From -70 to +30 LUFS
+#define LOUDNESS_MAX_CHANNELS   STEREO
+#define TRUEPEAK_PHASES         4       // 4x Oversampling
+#define TRUEPEAK_TAPS           12      // Taps per Polyphase Branch
+#define LOUDNESS_SILENCE        -144.0f // Reported When Nothing Was Measured
+
+/* Halfband Oversampling Around the Filters Near Nyquist */
+#define OVERSAMPLE_2X_CUTOFF    0.20    // Cutoff / Sample Rate Above Which the Filters Run at 2x
+#define OVERSAMPLE_4X_CUTOFF    0.35    // And at 4x
+#define HALFBAND_TAPS_2X        48      // FIR Taps per Phase, Into and Out of 2x, Multiple of 4
+#define HALFBAND_TAPS_4X        12      // Between 2x and 4x, Where the Transition is Wide
+#define HALFBAND_KAISER_BETA    8.0     // ~80dB Image Rejection
+#define OVERSAMPLE_PAD_4X       ((HALFBAND_TAPS_4X - 1) % 2)                    // 2x Samples Rounding the 4x Stage to Whole Frames
+#define OVERSAMPLE_PAD_2X       (HALFBAND_TAPS_4X - 1 + OVERSAMPLE_PAD_4X)      // 2x Samples Standing in for the 4x Stage
+#define OVERSAMPLE_LATENCY      (HALFBAND_TAPS_2X - 1 + OVERSAMPLE_PAD_2X / 2)  // Frames, Every Rate and Filters Off Alike
+#define OVERSAMPLE_PRIME_FRAMES 128     // Input Fed to a Rate's Path Before its Crossfade
+#define OVERSAMPLE_FADE_FRAMES  FRAMES_PER_BUFFER   // Crossfade Length, However the Blocks Fall
+
+/* Envelope Follower for the Renderer */
+#define ENVELOPE_WINDOW         1024    // Frames in the Running RMS Sum
+#define ENVELOPE_ATTACK_MS      10.0
+#define ENVELOPE_RELEASE_MS     300.0
+
+/* Lookahead Peak Limiter */
+#define LIMITER_CEILING_DB      -1.0    // dBFS
+#define LIMITER_RELEASE_MS      80.0
+#define LIMITER_LOOKAHEAD_MS    5.0     // Default, Override With --lookahead
+#define LIMITER_MAX_LOOKAHEAD   2048    // Frames, Power of Two for Ring Masks
+#define LIMITER_CHUNK           256     // Frames of Gain Computed Before Applying
+
+/* K-Weighted Biquad (Direct Form I, Double Precision) */
+typedef struct {
+    double b0, b1, b2, a1, a2;
+    double x1[LOUDNESS_MAX_CHANNELS], x2[LOUDNESS_MAX_CHANNELS];
+    double y1[LOUDNESS_MAX_CHANNELS], y2[LOUDNESS_MAX_CHANNELS];
+} kBiquad;
+
+/* Readings Published From the Audio Thread, Read by printGUI */
+typedef struct {
+    _Atomic float momentary;        // LUFS
+    _Atomic float shortTerm;        // LUFS
+    _Atomic float integrated;       // LUFS
+    _Atomic float truePeak;         // dBTP, Max Since Start
+    _Atomic unsigned int sequence;  // Bumped Once per Hop
+} loudnessReadings;
+
+/* Streaming BS.1770 / EBU R128 Meter State */
+typedef struct {
+    int    numChannels;
+    int    hopFrames;
+
+    /* K-Weighting: Pre-Filter Shelf Followed by RLB Highpass */
+    kBiquad shelf;
+    kBiquad rlb;
+
+    /* Current Hop Accumulator and Ring of Finished Hop Mean Squares */
+    double hopSum;
+    int    hopCount;
+    double hopHistory[LOUDNESS_SHORTTERM_HOPS];
+    int    hopIndex;
+    int    hopsFilled;
+
+    /* Gating Histogram of 400ms Block Energies for Integrated Loudness */
+    double histEnergy[LOUDNESS_HIST_BINS];
+    unsigned int histCount[LOUDNESS_HIST_BINS];
+    double gatedEnergy;
+    unsigned int gatedCount;
+
+    /* True Peak Polyphase History, Written Twice to Avoid Wrapping */
+    float  tpHistory[LOUDNESS_MAX_CHANNELS][TRUEPEAK_TAPS * 2];
+    int    tpIndex;
+    float  tpMax;
+
+    loudnessReadings readings;
+} loudnessMeter;
+
+
+/* Per-Channel RMS and Peak Envelopes, Published for the Renderer */
+typedef struct {
+    int    numChannels;
+    int    sampleRate;
+
+    /* Running Sum of Squares Over the Last ENVELOPE_WINDOW Frames */
+    float  squares[ENVELOPE_WINDOW][STEREO];
+    double sumSquares[STEREO];
+    int    writeIndex;
+
+    /* Attack/Release Smoothed Envelopes */
+    float  rmsEnv[STEREO];
+    float  peakEnv[STEREO];
+
+    _Atomic float rms[STEREO];
+    _Atomic float peak[STEREO];
+    _Atomic float rmsMix;                       // Mean of the Channel RMS Envelopes
+} envelopeFollower;
+
+/* Lookahead Peak Limiter State */
+typedef struct {
+    int    numChannels;
+    int    lookahead;                           // Frames of Delay == Reported Latency
+    float  ceiling;
+    float  releaseCoeff;
+
+    /* Input Delay Line, Interleaved */
+    float  delay[LIMITER_MAX_LOOKAHEAD * STEREO];
+
+    /* Monotonic Deque of Frame Indices for the Sliding Window Peak */
+    float  peaks[LIMITER_MAX_LOOKAHEAD];
+    unsigned int deque[LIMITER_MAX_LOOKAHEAD];
+    unsigned int dequeHead, dequeTail;
+
+    /* Release Smoothed Gain and its Moving Average Over the Window */
+    float  held;
+    float  gainRing[LIMITER_MAX_LOOKAHEAD];
+    double gainSum;
+
+    unsigned int frame;                         // Running Frame Counter, Wraps
+    float  gains[LIMITER_CHUNK];
+    _Atomic float gainReduction;                // dB, Deepest in Last Block
+} peakLimiter;
+
+/* Deinterleaved Output History, Written Only by the Audio Thread */
+typedef struct {
+    int   numChannels;
+    float ring[STEREO][VISUAL_HISTORY];
+    atomic_uint writePos;                       // Frames Written So Far, Wraps
+} channelHistory;
+
+/* One Window of Decoded Frames, Position p Lives in Slot p & (CACHE_FRAMES - 1) */
+typedef struct {
+    float *frames;
+    atomic_llong start;                         // Valid Stream Positions [start, end)
+    atomic_llong end;
+} cacheWindow;
+
+/* Decoded Audio Around the Playhead, Filled by a Reader Thread so the Audio
+   Callback Never Touches the Disk. Stream Positions Count Frames Played and
+   Run Past the End of the File as it Loops. Offline, frameCacheService()
+   Does the Reader's Work Between Blocks Instead. */
+typedef struct {
+    bool        running;
+    bool        synchronous;                    // No Reader Thread, See frameCacheService()
+    int         numChannels;
+    sf_count_t  fileFrames;
+    SNDFILE    *file;                           // Reader Thread's Own Handle
+    sf_count_t  fileCursor;                     // Next Frame the Handle Reads, -1 Unknown
+    cacheWindow windows[2];                     // Live Window + One for Prefetching Far Seeks
+    pthread_t   thread;
+    atomic_bool quit;
+
+    /* Control -> Reader */
+    atomic_uint  seekRequests;
+    atomic_llong seekTarget;
+
+    /* Reader -> Audio */
+    atomic_uint  seekPublished;
+    atomic_int   seekWindow;
+    atomic_llong seekPosition;
+
+    /* Audio -> Reader */
+    atomic_uint  seekApplied;
+    atomic_llong playPosition;
+    atomic_int   direction;                     // +1 Forward, -1 Backward
+    atomic_uint  underruns;                     // Blocks Played With Missing Frames
+
+    /* Audio Thread Only */
+    int          window;
+    sf_count_t   position;
+    unsigned int seekSeen;
+
+    /* Reader Only */
+    unsigned int handled;                       // Seek Requests Serviced
+    unsigned int published;
+    int          current;                       // Window Being Filled
+} frameCache;
+
+/* One Queued Event, Formatted Later by the Drainer */
+typedef struct {
+    int        code;                            // LOG_*
+    int        detail;
+    int        deck;                            // 0 for Deck A, 1 for Deck B
+    sf_count_t position;                        // Stream Frame it Happened at
+} logRecord;
+
+/* Single-Producer Ring From One Real-Time Thread to the Drainer */
+typedef struct {
+    logRecord   records[LOG_RING_SIZE];
+    atomic_uint head;                           // Written Only by its Producer
+    atomic_uint tail;                           // Written Only by the Drainer
+} logRing;
+
+/* Rings From the Audio Thread and the Deck Worker to a Drainer Thread */
+typedef struct {
+    logRing     rings[LOG_PRODUCERS];
+    atomic_uint dropped;                        // Events Lost to a Full Ring
+    FILE       *file;
+    pthread_t   thread;
+    atomic_bool quit;
+    bool        running;
+
+    /* Latest Line for the Panel */
+    pthread_mutex_t lock;
+    char         lastLine[128];
+    unsigned int total;
+} eventLog;
+
+/* One Control Change. Recorded and Scripted Changes Carry the Output Frame
+   They Take Effect on, Live Ones are Stamped When the Audio Thread Applies Them. */
+typedef struct {
+    sf_count_t frame;
+    int        control;                         // AUTO_*
+    int        deck;                            // 0 for Deck A, 1 for Deck B
+    bool       relative;                        // Live Nudge, value is a Delta
+    double     value;
+} controlChange;
+
+/* Control Changes Into the Audio Thread, Back Out to the Recorder, and a Script */
+typedef struct {
+    /* UI -> Audio */
+    controlChange incoming[AUTOMATION_RING_SIZE];
+    atomic_uint   incomingHead;
+    atomic_uint   incomingTail;
+
+    /* Audio -> Recorder, Every Change as Applied */
+    controlChange applied[AUTOMATION_RING_SIZE];
+    atomic_uint   appliedHead;
+    atomic_uint   appliedTail;
+    atomic_uint   dropped;
+    bool          recording;
+    FILE         *recordFile;
+
+    /* Loaded Whole Before Playback Starts */
+    controlChange *script;
+    int           scriptLength;
+    int           scriptNext;                   // Audio Thread Only
+    atomic_int    played;                       // scriptNext for the Panel
+
+    sf_count_t    frame;                        // Output Frames Rendered, Audio Thread Only
+    atomic_uint   sequence;                     // Bumped per Applied Change, Refreshes the Panel
+} automation;
+
+/* Unit Circle for One Segment Count, Rebuilt Only When the Count Changes */
+typedef struct {
+    int   segments;
+    float cosTable[RING_MAX_SEGMENTS];
+    float sinTable[RING_MAX_SEGMENTS];
+} ringTable;
+
+/* GPU Ring Buffer of Past Ring Snapshots, One Vertex Block per Frame */
+typedef struct {
+    bool    available;                          // Shader Built
+    bool    enabled;
+    int     rings;                              // Blocks in the Buffer
+    int     segments;                           // Vertices per Block
+    int     head;                               // Next Block to Overwrite
+    int     filled;
+    unsigned int frame;                         // Stamp Given to the Next Block
+
+    GLuint  vbo;
+    GLuint  program;
+    GLint   u_frame, u_rings, u_spread, u_opacity;
+    GLint   a_stamp;
+
+    /* Block Offsets Never Move, Only Their Contents */
+    GLint   firsts[TRAIL_MAX_RINGS];
+    GLsizei counts[TRAIL_MAX_RINGS];
+
+    GLfloat block[RING_MAX_SEGMENTS * TRAIL_VERTEX_FLOATS];
+} trailBuffer;
+
+/* Sidecar Header, Native Byte Order. Followed by the Levels, Each an Array
+   of [bin][channel][min, max, rms] int16 Triples, 8-Byte Aligned. */
+typedef struct {
+    char    magic[8];
+    int64_t sourceSize;                         // Audio File Size and mtime When Built
+    int64_t sourceMtime;
+    int64_t frames;
+    int32_t sampleRate;
+    int32_t numChannels;
+    int32_t baseShift;
+    int32_t numLevels;
+    int64_t levelBins[PYRAMID_MAX_LEVELS];
+    int64_t levelOffset[PYRAMID_MAX_LEVELS];    // Bytes From the Start of the Header
+} pyramidHeader;
+
+/* Whole-Track min/max/RMS Pyramid and its Overview Strip */
+typedef struct {
+    const char* sourcePath;
+    char    sidecarPath[4096];
+    atomic_int state;                           // OVERVIEW_*, Release-Stored by the Builder
+
+    /* Either a Mapped Sidecar or the Image Built in Memory */
+    const pyramidHeader* header;
+    const int16_t* levels[PYRAMID_MAX_LEVELS];
+    void*   mapping;
+    size_t  mappingSize;
+    void*   storage;
+    size_t  storageSize;
+    double  buildTime;
+    bool    saved;
+
+    /* Strip Geometry, Rebuilt Only on Resize */
+    bool    visible;
+    GLuint  vbo;
+    int     vboWidth, vboHeight;
+} waveformOverview;
+
+/* Render Loop Pacing and Per-Frame Cost */
+typedef struct {
+    double targetPeriod;                        // Seconds per Frame at the Cap
+    double nextDeadline;
+    unsigned int lastSequence;                  // Audio Block Last Drawn
+
+    /* VSync Detection From How Long the Swap Blocks */
+    bool   vsync;
+    double swapTime;                            // Moving Averages, Seconds
+    double frameInterval;
+    double lastSwapEnd;
+
+    /* Costs */
+    double cpuTime;
+    double gpuTime;
+    bool   gpuTimer;
+    GLuint queries[2];                          // Ping-Pong so Reads Never Stall
+    int    queryIndex;
+
+    /* Readout Window */
+    int    framesDrawn;
+    int    framesSkipped;
+    double windowStart;
+    double windowThreadCpu;
+} frameScheduler;
+
+/* Command Line Options */
+typedef struct {
+    const char* inFile;
+    const char* deckFile;                       // Second Input, Played on Deck B
+    bool  bench;
+    bool  benchSweep;                           // Machine-Readable Sweep, Honors --format and --out
+    float lookahead_ms;
+    int   src_type;                             // -1 Calibrates
+    double src_budget;                          // Share of the Block Deadline the Resampler May Use
+    bool  recalibrate;
+    int   max_fps;
+    int   trail_rings;
+    int   ring_mode;
+
+    /* Offscreen Export */
+    const char* exportDir;
+    int   export_fps;
+    int   export_width;
+    int   export_height;
+    int   export_threads;                       // 0 Uses Every Online Core, Analysis Too
+    bool  export_png;
+
+    /* Batch Analysis, Format and Output Shared With the Benchmark Sweep */
+    bool  analyze;
+    bool  analyzeJson;
+    const char*  analyzeOut;                    // NULL Writes to stdout
+    const char*  analyzeList;                   // One Path per Line, "-" Reads stdin
+    const char** inputs;                        // Every Positional Argument
+    int   numInputs;
+
+    /* Golden-Output Regression */
+    const char* goldenDir;
+    bool  goldenRecord;                         // Write the Goldens Instead of Comparing
+    double goldenSNR;                           // Pass Thresholds, dB
+    double goldenPeakError;
+
+    const char* logFile;
+
+    /* Parameter Automation */
+    const char* automationRecord;
+    const char* automationPlay;
+
+    /* Real-Time Setup */
+    bool  lock_memory;
+    int   rt_policy;                            // SCHED_OTHER Leaves the Audio Thread Alone
+    int   rt_priority;
+    const char* affinity[RT_THREAD_COUNT];      // CPU List per Thread Role, NULL Leaves it Alone
+} appOptions;
+
+/* One Halfband Stage, Polyphase: One Phase is an FIR, the Other a Delay */
+typedef struct {
+    int    taps;
+    float  coeffs[HALFBAND_TAPS_2X];                                    // Symmetric
+    float  up[STEREO][HALFBAND_TAPS_2X + FRAMES_PER_BUFFER * 2];        // Input History, Oldest First
+    float  even[STEREO][HALFBAND_TAPS_2X + FRAMES_PER_BUFFER * 2];      // Decimator's FIR Phase
+    float  odd[STEREO][HALFBAND_TAPS_2X / 2 + FRAMES_PER_BUFFER * 2];   // Decimator's Delay Phase
+} halfbandStage;
+
+/* One Rate's Way Through the Filters, Delayed to the Same Latency as the Others */
+typedef struct {
+    int           factor;                       // 1, 2 or 4
+    halfbandStage stages[2];                    // 1x to 2x, 2x to 4x
+    int           pad;                          // Delay Line Length, at 1x or Just Above the First Stage
+    float         delay[STEREO][OVERSAMPLE_LATENCY + FRAMES_PER_BUFFER * 2];     // Oldest First
+    float         lpfState[8], hpfState[8];     // Outgoing Path's Biquads During a Crossfade
+} filterPath;
+
+/* What the Filters Were Set to for a Block */
+typedef struct {
+    bool   lpfOn, hpfOn;
+    int    lpfFreq, lpfRes, hpfFreq, hpfRes;
+} filterSettings;
+
+/* Filters Run at 1x, 2x or 4x Depending on the Highest Cutoff */
+typedef struct {
+    filterPath paths[2];                        // The One Playing, and the Other While Crossfading to it
+    int    current;
+    filterSettings settings[2];                 // What Each Path Runs
+    int    fadeDone;                            // Crossfade Frames Played, OVERSAMPLE_FADE_FRAMES When Idle
+    float  input[STEREO][OVERSAMPLE_PRIME_FRAMES + FRAMES_PER_BUFFER];       // Recent Input, Oldest First
+    float  prime[OVERSAMPLE_PRIME_FRAMES * STEREO];
+    float  fade[FRAMES_PER_BUFFER * STEREO];        // Outgoing Path's Output
+    float  buffer[FRAMES_PER_BUFFER * 4 * STEREO];  // Interleaved at the Oversampled Rate
+    float  middle[FRAMES_PER_BUFFER * 2 * STEREO];  // At 2x, Between the Stages
+    float  fir[FRAMES_PER_BUFFER * 2];              // One Channel of FIR Phase Output
+} oversampler;
+
+/* Converter Ladder, Stepped Down When Callbacks Near Their Deadline */
+typedef struct {
+    SRC_STATE* states[GOVERNOR_LEVELS];         // NULL Above the Ceiling
+    int        ceiling;                         // Calibrated Converter, Never Exceeded
+    int        level;                           // Converter Feeding the Output
+    int        target;                          // Converter the Governor Wants Next
+    double     deadline;                        // Seconds of Audio per Callback
+
+    /* Moving p99 of Callback Durations, in Bins of 1% of the Deadline */
+    unsigned char recent[GOVERNOR_WINDOW];
+    int        histogram[GOVERNOR_BINS];
+    int        filled, next, checks, calm;
+    int        measured;                        // Converter the Window Describes
+    atomic_int p99;                             // Percent, Read by the Panel
+    atomic_int playing;                         // Level, Read by the Panel
+
+    /* Input Frame Behind the Next Output Frame, Whatever the Converter Buffers */
+    sf_count_t origin;                          // Playhead at the Last src_reset()
+    double     heard;                           // Input Frames Covered by Output Since
+    bool       fresh;                           // No Ramp From a last_ratio on the First Call
+
+    /* Converter Being Primed or Faded In */
+    SRC_DATA   block;
+    sf_count_t position;
+    float      input[FRAMES_PER_BUFFER * 16];
+    float      output[FRAMES_PER_BUFFER * 2];   // Primed Frames, Thrown Away
+} srcGovernor;
 
 /* Global Sound Data Struct */
  typedef struct {
@@ -78,7 +719,8 @@
 
     /* Sample Rate Converter Members */
     SRC_DATA   src_data;
-    SRC_STATE* src_state;
+    SRC_STATE* src_state;                       // Current Rung of the Governor's Ladder
+    srcGovernor governor;
 
     int    src_error;
     int    src_converter_type;
@@ -100,13 +742,78 @@
     /* Filter On/Off */
     char* filterState[2];
 
+    /* Filter Histories, x1 x2 y1 y2 Left Then Right */
+    float lpfState[8];
+    float hpfState[8];
+
+    /* Filters Near Nyquist Run Oversampled */
+    oversampler oversampler;
+
+    /* Lookahead Limiter Ahead of the Output Gain */
+    peakLimiter limiter;
+
+    /* Level Envelopes for the Visuals */
+    envelopeFollower envelope;
+
+    /* Per-Channel Sample History for the Visuals */
+    channelHistory history;
+
+    /* Decoded Frames Around the Playhead, Feeds the Callback */
+    frameCache cache;
+
+    /* Unity Speed Copies From the Cache, the Other Path of a Crossfade Lands Here */
+    bool  bypassed;
+    float fadeBuffer[FRAMES_PER_BUFFER * 2];
+
+    /* Platter Motion, Negative Speeds Play Backwards */
+    int    direction;                           // Motor Direction, Flipped With 'b'
+    int    motor;                               // PLATTER_MOTOR_ON, _BRAKE or _OFF
+    double speed;                               // Signed Platter Speed, Audio Thread Only
+    atomic_bool    scratching;                  // Hand on the Record Overrides the Motor
+    _Atomic double scratchSpeed;                // Hand Velocity, Written by the Mouse Handlers
+
+    /* File Frame Under the Playhead, Drives the Overview and Position Readout */
+    atomic_llong playhead;
+
+    /* Loudness Meter on the Post-Gain Output */
+    loudnessMeter meter;
+
+    /* Control Changes, Applied and Recorded on the Audio Thread */
+    automation automation;
+
+    /* Mixer, Deck B Joins Deck A's Output Here */
+    double crossfader;                          // 0 is All Deck A, 1 All Deck B
+    double mixGains[2];                         // Equal-Power Gains at the End of the Last Block
+
     /* OpenGL Members */
     float gl_audioBuffer[ITEMS_PER_BUFFER];    
 } paData;
 
+/* Second Deck's Thread, Handed One Block at a Time by the Audio Callback */
+typedef struct {
+    paData         *deck;
+    pthread_t       thread;
+    bool            running;
+    atomic_bool     quit;
+    atomic_uint     posted;                     // Blocks Handed Over
+    atomic_uint     claimed;                    // Blocks Taken, by the Worker or the Callback
+    atomic_uint     finished;                   // Blocks Done
+    unsigned long   frames;                     // Size of the Posted Block
+    pthread_mutex_t lock;                       // Only Guards the Worker's Sleep
+    pthread_cond_t  wake;
+} deckWorker;
+
 /* Global Data Initialized */
 paData data;
+paData deckB;                                   // Second Deck, Idle Unless a Second File is Given
+paData *g_deck = &data;                         // Deck the Keys and Mouse Work On
+deckWorker g_deck_worker;
 PaStream *g_stream;
+appOptions g_options = { NULL, NULL, false, false, LIMITER_LOOKAHEAD_MS, -1, CALIBRATE_BUDGET, false, FRAME_RATE_CAP, TRAIL_DEFAULT_RINGS,
+                         RING_MODE_MIX, NULL, EXPORT_FPS, INIT_WIDTH, INIT_HEIGHT, 0, false,
+                         false, false, NULL, NULL, NULL, 0, NULL, false, GOLDEN_MIN_SNR, GOLDEN_MAX_PEAK_ERROR,
+                         LOG_DEFAULT_FILE, NULL, NULL,
+                         false, SCHED_OTHER, RT_DEFAULT_PRIORITY, { NULL } };
 
 // WxH Of OpenGL Window
 GLsizei g_width = INIT_WIDTH;
@@ -120,8 +827,62 @@ typedef char BYTE;   // 8-bit unsigned entity.
 //Global Audio Vars
 GLint g_buffer_size = FRAMES_PER_BUFFER;
 
-//Threads Management
-GLboolean g_ready = false;
+//Threads Management, Bumped by the Audio Thread Once per Block
+atomic_uint g_audio_sequence = 0;
+
+//The PortAudio Thread, Published by its First Callback
+pthread_t   g_audio_thread;
+atomic_bool g_audio_thread_known = false;
+
+// Frame Pacing
+frameScheduler g_frame;
+
+// Persistence Trails
+trailBuffer g_trail;
+
+// Whole-Track Overview
+waveformOverview g_overview;
+
+// Audio Thread Errors and Glitches
+eventLog g_log;
+static _Thread_local int g_event_ring = 0;     // Producer Ring of the Calling Thread
+static _Thread_local int g_event_deck = 0;     // Deck That Thread is Playing
+
+// Ring Geometry, Staged as [xyz * n | rgba * n] and Streamed Into One VBO per Ring
+GLuint  g_ring_vbo[2] = { 0, 0 };
+GLfloat g_ring_vertices[2][RING_MAX_SEGMENTS * 7];
+ringTable g_ring_table;
+int     g_ring_mode = RING_MODE_MIX;
+const char* ringModeNames[RING_MODE_COUNT] = { "Mix", "L Outer / R Inner", "Mid Outer / Side Inner",
+                                               "Deck A Outer / Deck B Inner" };
+const char* motorNames[3] = { "On", "Braking", "Power Off" };
+
+/* Control Names in Automation Files */
+const char* automationNames[AUTO_CONTROLS] = { "ratio", "direction", "motor", "lpf_on", "lpf_freq", "lpf_res",
+                                               "hpf_on", "hpf_freq", "hpf_res", "volume", "scratch",
+                                               "scratch_speed", "seek", "crossfader" };
+
+/* Range of Each Control, Those the Keys Keep. Scripts Outside it are Rejected
+   at Load, Anything Else is Clamped Before it Reaches a Deck. */
+const double automationLimits[AUTO_CONTROLS][2] = {
+    { 0.5 - SRC_RATIO_INCREMENT, 2.0 + SRC_RATIO_INCREMENT },      // ratio
+    { -1, 1 },                                                      // direction, Either End Only
+    { PLATTER_MOTOR_ON, PLATTER_MOTOR_OFF },                        // motor
+    { 0, 1 },                                                       // lpf_on
+    { 20, 20000 },                                                  // lpf_freq
+    { 1, 10 },                                                      // lpf_res
+    { 0, 1 },                                                       // hpf_on
+    { 20, 20000 },                                                  // hpf_freq
+    { 1, 10 },                                                      // hpf_res
+    { 0, 1 },                                                       // volume
+    { 0, 1 },                                                       // scratch
+    { -PLATTER_MAX_SPEED, PLATTER_MAX_SPEED },                      // scratch_speed
+    { 0, INFINITY },                                                // seek, Past the End Lands on the Last Frame
+    { 0, 1 } };                                                     // crossfader
+
+/* Best First, Zero Order Hold Only When Nothing Else Fits */
+const int srcLadder[GOVERNOR_LEVELS] = { SRC_SINC_BEST_QUALITY, SRC_SINC_MEDIUM_QUALITY, SRC_SINC_FASTEST,
+                                         SRC_LINEAR, SRC_ZERO_ORDER_HOLD };
 
 // Fill Mode
 GLenum g_fillmode = GL_FILL;
@@ -148,6 +909,14 @@ GLfloat g_inc_x = 0.0;
 bool g_key_rotate_y = false;
 bool g_key_rotate_x =  false;
 
+// Scratching, Last Mouse Sample While the Button is Down
+int    g_scratch_x = 0;
+double g_scratch_time = 0;
+bool   g_scratch_down = false;
+double g_scratch_speed = 0;                 // Last Speed Posted to the Audio Thread
+GLfloat g_angle_x = 0;
+GLfloat g_angle_y = 0;
+
 //-----------------------------------------------------------------------------
 // Function Prototypes
 //-----------------------------------------------------------------------------
@@ -159,26 +928,135 @@ void reshapeFunc( int width, int height );
 void keyboardFunc( unsigned char, int, int );
 void specialKey( int key, int x, int y );
 void specialUpKey( int key, int x, int y);
+void mouseFunc( int button, int state, int x, int y );
+void motionFunc( int x, int y );
 void initialize_graphics( );
 void initialize_glut(int argc, char *argv[]);
 void drawTimeDomain(SAMPLE *buffer, float R, float G, float B); 
 void rotateView();
-void drawCircle(float r, int num_segments, float* buffer, bool scalar);
+void updateRingTable(ringTable *table, int num_segments);
+int  ringLODVertices(int numSamples, int viewportHeight);
+void decimateMinMax(const float *samples, int numSamples, int numPairs, float *envelope);
+const float* ringLOD(const float *samples, int numSamples, int numVertices, float *envelope);
+void generateRingGeometry(const ringTable *table, const float *samples, int num_segments,
+                          float radius, float depth, float *positions, float *colors);
+void updateRingGeometry(int ring, float r, int num_segments, const float* buffer);
+void drawCircle(int ring, int num_segments, GLfloat scale);
+void splitRingChannels(int mode, const float *left, const float *right, int numFrames,
+                       float *outer, float *inner);
+void initialize_trail();
+void appendTrailBlock(int num_segments);
+void drawTrail();
+void initialize_frameScheduler();
+void printFrameStats();
+void initialize_overview(const char* inFile);
+void drawOverview();
+void printOverviewStatus();
+double getThreadCpuSeconds();
 
 /* Audio Processing Functions */
-void initialize_src_type();
-void initialize_audio(const char* inFile);
+double timeConverter(int type, int numChannels);
+void initialize_src_type(const char* inFile);
+void initialize_deck(paData *data, const char* inFile);
+void initialize_engine(const char* inFile, const char* deckFile);
+void initialize_audio(const char* inFile, const char* deckFile);
+void processAudio(paData *data, float *out, unsigned long framesPerBuffer);
+void deckProcess(paData *data, unsigned long framesPerBuffer);
+void deckVisualsWrite(paData *data, unsigned long framesPerBuffer);
+void mixDecks(paData *data, float *out, unsigned long framesPerBuffer);
+void platterProcess(paData *data, unsigned long framesPerBuffer);
+bool platterResample(paData *data, unsigned long framesPerBuffer, double target, double step, SRC_STATE *incoming);
+static void crossfade(float *dst, const float *from, const float *to, int numFrames, int numChannels);
+bool primeConverter(paData *data, SRC_STATE *state);
+void initialize_governor(srcGovernor *g, int converterType, int numChannels, int sampleRate);
+void governorObserve(srcGovernor *g, double seconds, sf_count_t position);
+bool governorPrime(paData *data);
+void stop_governor(srcGovernor *g);
 void stop_portAudio();
-void initialize_SRC_DATA();
-void initialize_Filters();
-static void lowPassFilter(float *inBuffer, int numChannels);
-static void highPassFilter(float *inBuffer, int numChannels);
+void initialize_SRC_DATA(paData *data);
+void initialize_Filters(paData *data);
+static void lowPassFilter(paData *data, float *inBuffer, int numFrames, int numChannels, double sampleRate, int freq, int res);
+static void highPassFilter(paData *data, float *inBuffer, int numFrames, int numChannels, double sampleRate, int freq, int res);
+int filterOversampling(paData *data);
+void filterProcess(paData *data, int numFrames);
+void initialize_oversampler(oversampler *os);
+static double besselI0(double x);
+void firSIMD(const float *in, const float *coeffs, int taps, float *out, int numOutputs);
+static void halfbandUp(halfbandStage *s, int ch, const float *in, int numFrames, float *out, int numChannels, float *fir);
+static void halfbandDown(halfbandStage *s, int ch, const float *in, int numFrames, float *out, int numChannels, float *fir);
 float computeRMS(float *buffer);
-void brickwall(float *buffer, int numChannels);
+void initialize_envelopeFollower(envelopeFollower *env, int sampleRate, int numChannels);
+void envelopeFollowerProcess(envelopeFollower *env, const float *buffer, int numFrames);
+void initialize_limiter(peakLimiter *lim, int sampleRate, int numChannels, float lookahead_ms);
+void brickwall(peakLimiter *lim, float *buffer, int numFrames);
+void applyGainSIMD(float *buffer, const float *gains, int numFrames, int numChannels);
+void mixSIMD(float *buffer, const float *other, const float *gains, const float *otherGains, int numFrames, int numChannels);
+void deinterleaveSIMD(const float *buffer, float *left, float *right, int numFrames);
+void initialize_channelHistory(channelHistory *h, int numChannels);
+void channelHistoryWrite(channelHistory *h, const float *buffer, int numFrames);
+void channelHistoryRead(channelHistory *h, float *left, float *right, int numFrames);
+static sf_count_t wrapFrame(sf_count_t position, sf_count_t frames);
+void initialize_frameCache(frameCache *c, const char* inFile, bool threaded);
+void stop_frameCache(frameCache *c);
+void frameCacheService(frameCache *c);
+bool frameCacheRead(frameCache *c, float *dst, int numFrames, int direction);
+void frameCachePeek(frameCache *c, float *dst, sf_count_t from, int numFrames, int direction);
+void frameCacheAdvance(frameCache *c, int numFrames);
+void seekTo(sf_count_t frame);
+void seekBy(double seconds);
+void requestSeek(paData *data, sf_count_t frame);
+void printCacheStatus();
+
+/* Loudness Metering Functions */
+void initialize_loudnessMeter(loudnessMeter *m, int sampleRate, int numChannels);
+void loudnessMeterProcess(loudnessMeter *m, const float *buffer, int numFrames);
 
 /* Command Line Prints */
+void parse_arguments(int argc, char *argv[]);
 void help();
 void printGUI();
+void printMeters();
+
+/* Benchmarks */
+double getTimeSeconds();
+void runBenchmarks();
+int runBenchSweep();
+int runGolden(const char* dir);
+
+/* Real-Time Setup */
+void reportRealtime(const char *format, ...);
+size_t prefaultMemory(void *buffer, size_t size);
+void pinThread(pthread_t thread, int role);
+void initialize_realtime();
+void promoteAudioThread();
+
+/* Event Log */
+void postEvent(int code, int detail, sf_count_t position);
+void initialize_eventLog(const char* path);
+void stop_eventLog();
+void printEventLog();
+
+/* Parameter Automation */
+void postControl(int control, double value);
+void nudgeControl(int control, double delta);
+void automationProcess(paData *data, float *out, unsigned long framesPerBuffer);
+bool initialize_automation(automation *a, const char* recordPath, const char* playPath);
+void drainAutomation(automation *a);
+void stop_automation(automation *a);
+void printAutomationStatus();
+
+/* Second Deck */
+void initialize_deckWorker(deckWorker *w);
+void deckWorkerPost(deckWorker *w, unsigned long framesPerBuffer);
+void deckWorkerWait(deckWorker *w);
+void stop_deckWorker(deckWorker *w);
+void readDeckRings(float *outer, float *inner, int numFrames);
+
+/* Offscreen Export */
+int runExport(const char* outDir);
+
+/* Batch Analysis */
+int runAnalysis();
 
 //-----------------------------------------------------------------------------
 // Name: Main
@@ -186,20 +1064,68 @@ void printGUI();
 //-----------------------------------------------------------------------------
 int main( int argc, char *argv[] )
 {
+    int status;
+
     /* Check Arguments */
-    if ( argc != 2 ) {
-        printf("Usage: %s: Input Audio\n", argv[0]);
-        return EXIT_FAILURE;
+    parse_arguments(argc, argv);
+
+    /* Benchmark Mode, No Audio Device or Window Needed */
+    if ( g_options.bench ) {
+        if ( g_options.benchSweep ) {
+            return runBenchSweep();
+        }
+        runBenchmarks();
+        return EXIT_SUCCESS;
+    }
+
+    /* Batch Feature Extraction, No Audio Device or Window Needed */
+    if ( g_options.analyze ) {
+        return runAnalysis();
+    }
+
+    /* Golden-Output Regression, Picks its Own Converter */
+    if ( g_options.goldenDir != NULL ) {
+        return runGolden(g_options.goldenDir);
     }
 
     /* Initialize SRC Algorithm */
-    initialize_src_type();
+    if ( g_options.src_type >= 0 ) {
+        data.src_converter_type = g_options.src_type;
+    }
+    else if ( g_options.exportDir != NULL ) {
+        data.src_converter_type = SRC_SINC_BEST_QUALITY;    //Offline, No Deadline
+    }
+    else
+        initialize_src_type(g_options.inFile);
+
+    /* Audio Thread Errors Drain to a File Instead of the Terminal */
+    initialize_eventLog(g_options.logFile);
+
+    /* Control Changes to Record, or a Script to Play Instead of the Keys */
+    if ( !initialize_automation(&data.automation, g_options.automationRecord, g_options.automationPlay) ) {
+        stop_eventLog();
+        return EXIT_FAILURE;
+    }
+
+    /* Offline Export Mode, No Audio Device or Window Needed */
+    if ( g_options.exportDir != NULL ) {
+        status = runExport(g_options.exportDir);
+        stop_automation(&data.automation);
+        stop_eventLog();
+        return status;
+    }
+
+    /* Lock Memory and Pin This Thread Before Anything Real-Time Starts */
+    initialize_realtime();
 
     /* Initialize Glut */
     initialize_glut(argc, argv);
 
     /* Initialize PortAudio */
-    initialize_audio(argv[1]);
+    initialize_audio(g_options.inFile, g_options.deckFile);
+
+    /* Whole-Track Overview, Mapped or Built in the Background */
+    initialize_overview(g_options.inFile);
 
     /* Start Curses Mode */
     initscr(); 
@@ -218,51 +1144,384 @@ int main( int argc, char *argv[] )
 }
 
 //-----------------------------------------------------------------------------
-// name: initialize_src_type
-// desc: Initializes SRC Algorithm, Stores Value in data.src_converter_type 
+// name: parse_arguments
+// desc: Fills g_options From the Command Line, Exits With Usage on Bad Input
 //-----------------------------------------------------------------------------
-void initialize_src_type()
+void parse_arguments(int argc, char *argv[])
 {
-    bool valid = false;
-    char buffer[4];
-    int  srcType;
-
-    /* Print User Menu */
-    printf("\nChoose The Quality of Sample Rate Conversion\n"
-            "Best Quality = 0\n"
-            "Medium Quality = 1\n"
-            "Fastest Quality = 2\n"
-            "Zero Order Hold = 3\n"
-            "Linear Processing = 4\n");
-    printf("Enter a Number Between 0 and 4 : ");
+    char *end;
+    int i;
 
-    /* Read From stdin, Convert to int */
-    while (!valid)
+    for (i = 1; i < argc; i++)
     {
-        if (fgets(buffer, sizeof(buffer), stdin) != NULL) 
+        if (strcmp(argv[i], "--bench") == 0)
         {
-            srcType = atoi(buffer);
+            g_options.bench = true;
         }
-
-        if (srcType > -1 && srcType < 5)
+        else if (strcmp(argv[i], "--sweep") == 0)
+        {
+            g_options.benchSweep = true;
+        }
+        else if (strcmp(argv[i], "--lookahead") == 0 && i + 1 < argc)
+        {
+            g_options.lookahead_ms = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--max-fps") == 0 && i + 1 < argc)
+        {
+            g_options.max_fps = atoi(argv[++i]);
+            if (g_options.max_fps < 1) {
+                g_options.max_fps = FRAME_RATE_CAP;
+            }
+        }
+        else if (strcmp(argv[i], "--trail") == 0 && i + 1 < argc)
+        {
+            g_options.trail_rings = atoi(argv[++i]);
+            if (g_options.trail_rings < 2 || g_options.trail_rings > TRAIL_MAX_RINGS) {
+                g_options.trail_rings = TRAIL_DEFAULT_RINGS;
+            }
+        }
+        else if (strcmp(argv[i], "--rings") == 0 && i + 1 < argc)
+        {
+            i++;
+            if (strcmp(argv[i], "lr") == 0) {
+                g_options.ring_mode = RING_MODE_LR;
+            }
+            else if (strcmp(argv[i], "ms") == 0) {
+                g_options.ring_mode = RING_MODE_MS;
+            }
+            else if (strcmp(argv[i], "decks") == 0) {
+                g_options.ring_mode = RING_MODE_DECKS;
+            }
+            else if (strcmp(argv[i], "mix") == 0) {
+                g_options.ring_mode = RING_MODE_MIX;
+            }
+            else
+            {
+                printf("Error, Unknown --rings Mode %s, Expected mix, lr, ms or decks\n", argv[i]);
+                exit(EXIT_FAILURE);
+            }
+        }
+        else if (strcmp(argv[i], "--src") == 0 && i + 1 < argc)
+        {
+            g_options.src_type = (int)strtol(argv[++i], &end, 10);
+            if (end == argv[i] || *end != '\0' || g_options.src_type < SRC_SINC_BEST_QUALITY || g_options.src_type > SRC_LINEAR)
+            {
+                printf("Error, Bad --src %s, Expected 0 (Best Sinc) to 4 (Linear)\n", argv[i]);
+                exit(EXIT_FAILURE);
+            }
+        }
+        else if (strcmp(argv[i], "--src-budget") == 0 && i + 1 < argc)
+        {
+            g_options.src_budget = strtod(argv[++i], &end);
+            if (end == argv[i] || *end != '\0' || !(g_options.src_budget > 0 && g_options.src_budget <= 1))
+            {
+                printf("Error, Bad --src-budget %s, Expected a Share of the Deadline Above 0 and up to 1\n", argv[i]);
+                exit(EXIT_FAILURE);
+            }
+        }
+        else if (strcmp(argv[i], "--calibrate") == 0)
+        {
+            g_options.recalibrate = true;
+        }
+        else if (strcmp(argv[i], "--export") == 0 && i + 1 < argc)
+        {
+            g_options.exportDir = argv[++i];
+        }
+        else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc)
+        {
+            g_options.export_fps = atoi(argv[++i]);
+            if (g_options.export_fps < 1) {
+                g_options.export_fps = EXPORT_FPS;
+            }
+        }
+        else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc)
+        {
+            if (sscanf(argv[++i], "%dx%d", &g_options.export_width, &g_options.export_height) != 2 ||
+                g_options.export_width < 16 || g_options.export_height < 16)
+            {
+                g_options.export_width  = INIT_WIDTH;
+                g_options.export_height = INIT_HEIGHT;
+            }
+        }
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+        {
+            g_options.export_threads = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--png") == 0)
+        {
+            g_options.export_png = true;
+        }
+        else if (strcmp(argv[i], "--analyze") == 0)
+        {
+            g_options.analyze = true;
+        }
+        else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc)
+        {
+            g_options.analyzeJson = strcmp(argv[++i], "json") == 0;
+        }
+        else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc)
+        {
+            g_options.analyzeOut = argv[++i];
+        }
+        else if (strcmp(argv[i], "--golden") == 0 && i + 1 < argc)
+        {
+            g_options.goldenDir = argv[++i];
+        }
+        else if (strcmp(argv[i], "--record") == 0)
+        {
+            g_options.goldenRecord = true;
+        }
+        else if (strcmp(argv[i], "--snr") == 0 && i + 1 < argc)
+        {
+            g_options.goldenSNR = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--peak-error") == 0 && i + 1 < argc)
+        {
+            g_options.goldenPeakError = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--list") == 0 && i + 1 < argc)
         {
-            valid = true;
+            g_options.analyzeList = argv[++i];
+        }
+        else if (strcmp(argv[i], "--log") == 0 && i + 1 < argc)
+        {
+            g_options.logFile = argv[++i];
+        }
+        else if (strcmp(argv[i], "--record-automation") == 0 && i + 1 < argc)
+        {
+            g_options.automationRecord = argv[++i];
+        }
+        else if (strcmp(argv[i], "--play-automation") == 0 && i + 1 < argc)
+        {
+            g_options.automationPlay = argv[++i];
+        }
+        else if (strcmp(argv[i], "--mlock") == 0)
+        {
+            g_options.lock_memory = true;
+        }
+        else if (strcmp(argv[i], "--sched") == 0 && i + 1 < argc)
+        {
+            i++;
+            if (strcmp(argv[i], "fifo") == 0) {
+                g_options.rt_policy = SCHED_FIFO;
+            }
+            else if (strcmp(argv[i], "rr") == 0) {
+                g_options.rt_policy = SCHED_RR;
+            }
+            else
+            {
+                printf("Error, Unknown --sched Policy %s, Expected fifo or rr\n", argv[i]);
+                exit(EXIT_FAILURE);
+            }
+        }
+        else if (strcmp(argv[i], "--priority") == 0 && i + 1 < argc)
+        {
+            g_options.rt_priority = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--affinity") == 0 && i + 1 < argc)
+        {
+            /* role=cpus, Repeated per Role */
+            i++;
+            if (strncmp(argv[i], "audio=", 6) == 0) {
+                g_options.affinity[RT_THREAD_AUDIO] = argv[i] + 6;
+            }
+            else if (strncmp(argv[i], "reader=", 7) == 0) {
+                g_options.affinity[RT_THREAD_READER] = argv[i] + 7;
+            }
+            else if (strncmp(argv[i], "analysis=", 9) == 0) {
+                g_options.affinity[RT_THREAD_ANALYSIS] = argv[i] + 9;
+            }
+            else if (strncmp(argv[i], "render=", 7) == 0) {
+                g_options.affinity[RT_THREAD_RENDER] = argv[i] + 7;
+            }
+            else
+            {
+                printf("Error, Unknown --affinity Role in %s, Expected audio, reader, analysis or render=cpus\n", argv[i]);
+                exit(EXIT_FAILURE);
+            }
+        }
+        else if (argv[i][0] != '-')
+        {
+            if (g_options.inputs == NULL) {
+                g_options.inputs = malloc(argc * sizeof(char*));
+            }
+            g_options.inputs[g_options.numInputs++] = argv[i];
+            g_options.inFile = g_options.inputs[0];
         }
         else
-            valid = false;
+        {
+            g_options.inFile = NULL;
+            g_options.analyze = false;
+            break;
+        }
+    }
+
+    /* Playback Takes a File per Deck, Only Analysis Takes More */
+    if (g_options.numInputs == 2 && !g_options.analyze) {
+        g_options.deckFile = g_options.inputs[1];
+    }
+    if (g_options.numInputs > 2 && !g_options.analyze) {
+        g_options.inFile = NULL;
+    }
+
+    if (g_options.inFile == NULL && !g_options.bench && g_options.goldenDir == NULL &&
+        !(g_options.analyze && g_options.analyzeList != NULL))
+    {
+        printf("Usage: %s [--lookahead ms] [--src 0-4 | --src-budget f [--calibrate]] [--max-fps n] [--trail rings] [--rings mix|lr|ms|decks] [--log file]\n"
+               "          [--mlock] [--sched fifo|rr] [--priority n] [--affinity audio|reader|render=cpus]\n"
+               "          [--record-automation file] [--play-automation file] Input Audio [Deck B Audio]\n"
+               "       %s --export dir [--fps n] [--size WxH] [--threads n] [--png] [--rings mix|lr|ms|decks] [--log file]\n"
+               "          [--record-automation file] [--play-automation file] Input Audio [Deck B Audio]\n"
+               "       %s --analyze [--format csv|json] [--out file] [--threads n] [--list file|-] [--affinity analysis=cpus] Input Audio...\n"
+               "       %s --golden dir [--record] [--snr dB] [--peak-error dB] [--src 0-4] [--lookahead ms] [--play-automation file]\n"
+               "       %s --bench [--sweep [--format csv|json] [--out file]]\n", argv[0], argv[0], argv[0], argv[0], argv[0]);
+        exit(EXIT_FAILURE);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// name: timeConverter(int type, int numChannels)
+// desc: 90th Percentile Seconds for One Block at the Worst-Case Motor Ratio,
+//       HUGE_VAL When the Converter Can't Run at All
+//-----------------------------------------------------------------------------
+static int compareDoubles(const void *a, const void *b)
+{
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+double timeConverter(int type, int numChannels)
+{
+    static float input[CALIBRATE_INPUT_FRAMES * STEREO];
+    static float output[FRAMES_PER_BUFFER * STEREO];
+    double   times[CALIBRATE_BLOCKS], start;
+    SRC_STATE *state;
+    SRC_DATA   block;
+    int i, error;
+
+    /* The Buffers Hold at Most Stereo, as Does the Engine */
+    if (numChannels < MONO || numChannels > STEREO) {
+        return HUGE_VAL;
+    }
+    if ((state = src_new(type, numChannels, &error)) == NULL) {
+        return HUGE_VAL;
+    }
+
+    srand(1);
+    for (i = 0; i < (int)(sizeof(input) / sizeof(input[0])); i++) {
+        input[i] = (float)rand() / RAND_MAX - 0.5f;
+    }
+
+    memset(&block, 0, sizeof(block));
+    block.data_in       = input;
+    block.data_out      = output;
+    block.input_frames  = CALIBRATE_INPUT_FRAMES;
+    block.output_frames = FRAMES_PER_BUFFER;
+    block.src_ratio     = CALIBRATE_RATIO;
+
+    /* First Blocks Warm the Caches and Fill the Filter */
+    for (i = -CALIBRATE_BLOCKS / 4; i < CALIBRATE_BLOCKS; i++)
+    {
+        start = getTimeSeconds();
+        if (src_process(state, &block) != 0)
+        {
+            src_delete(state);
+            return HUGE_VAL;
+        }
+        if (i >= 0) {
+            times[i] = getTimeSeconds() - start;
+        }
+    }
+    src_delete(state);
+
+    qsort(times, CALIBRATE_BLOCKS, sizeof(double), compareDoubles);
+    return times[CALIBRATE_BLOCKS * 9 / 10];
+}
+
+//-----------------------------------------------------------------------------
+// name: initialize_src_type
+// desc: Picks the Best Converter That Fits --src-budget of the Block Deadline
+//       on This Machine. Results are Cached in $HOME per Host, Channel Count,
+//       Sample Rate and Budget, so Only the First Start Pays for Timing.
+//-----------------------------------------------------------------------------
+void initialize_src_type(const char* inFile)
+{
+    char    path[1024], host[256], line[1024], key[512];
+    const char *home = getenv("HOME");
+    SF_INFO info;
+    SNDFILE *file;
+    FILE   *cache;
+    double  deadline, elapsed;
+    int     i, srcType = -1;
+
+    memset(&info, 0, sizeof(info));
+    if ((file = sf_open(inFile, SFM_READ, &info)) == NULL) {
+        info.channels   = STEREO;
+        info.samplerate = SAMPLING_RATE;
+    }
+    else {
+        sf_close(file);
+    }
+
+    /* Same Check initialize_deck() Makes, Before Anything is Timed or Cached */
+    if (info.channels > STEREO)
+    {
+        printf("Error, File Must be Stereo or Mono\n");
+        exit (1);
+    }
+
+    if (gethostname(host, sizeof(host)) != 0) {
+        strcpy(host, "localhost");
+    }
+    host[sizeof(host) - 1] = '\0';
+    snprintf(key, sizeof(key), "%s %d %d %d %.3f", host, info.channels, info.samplerate,
+             FRAMES_PER_BUFFER, g_options.src_budget);
+    snprintf(path, sizeof(path), "%s/%s", home != NULL ? home : ".", CALIBRATE_FILE);
 
-        if (!valid)
+    /* Last Matching Line Wins */
+    if (!g_options.recalibrate && (cache = fopen(path, "r")) != NULL)
+    {
+        while (fgets(line, sizeof(line), cache) != NULL)
         {
-            printf("Error: Please Enter a Number Between 0 and 4 : ");
+            if (strncmp(line, key, strlen(key)) == 0 && line[strlen(key)] == ' ') {
+                srcType = atoi(line + strlen(key) + 1);
+            }
         }
+        fclose(cache);
     }
 
-    /* Intialize SRC Algorithm */
-    if (valid == true)
+    if (srcType >= SRC_SINC_BEST_QUALITY && srcType <= SRC_LINEAR)
     {
+        printf("\nSRC: %s, Calibrated Earlier for This Machine (--calibrate to Redo)\n", src_get_name(srcType));
         data.src_converter_type = srcType;
+        return;
+    }
+
+    /* Time Each Converter at the Fastest Motor Speed, Where Sinc Costs the Most */
+    deadline = (double)FRAMES_PER_BUFFER / info.samplerate;
+    printf("\nCalibrating SRC: %d ch, %d Hz, Ratio %.2f, Budget %.0f%% of %.1f ms\n",
+           info.channels, info.samplerate, CALIBRATE_RATIO, 100.0 * g_options.src_budget, deadline * 1000.0);
+
+    srcType = SRC_ZERO_ORDER_HOLD;
+    for (i = 0; i < GOVERNOR_LEVELS; i++)
+    {
+        elapsed = timeConverter(srcLadder[i], info.channels);
+        printf("  %-32s %8.1f us/block, %5.1f%%\n", src_get_name(srcLadder[i]), elapsed * 1e6,
+               100.0 * elapsed / deadline);
+        if (elapsed <= g_options.src_budget * deadline)
+        {
+            srcType = srcLadder[i];
+            break;
+        }
     }
+    printf("SRC: %s\n", src_get_name(srcType));
+    data.src_converter_type = srcType;
 
+    if ((cache = fopen(path, "a")) != NULL)
+    {
+        fprintf(cache, "%s %d\n", key, srcType);
+        fclose(cache);
+    }
 }
 
 //-----------------------------------------------------------------------------
@@ -281,10 +1540,11 @@ void help()
      "'i/o' - Increase/Decrease LPF Resonance by 1.0 Q Factor\n" 
      "'s/d' - Increase/Decrease HPF Freq. Cutoff by 100hz\n" 
      "'w/e' - Increase/Decrease HPF Resonance by 1.0 Q Factor\n" 
-     "'-/=' - Increase/Decrease Speed/Pitch\n" 
-     "'m'   - To Mute Output Audio\n" 
-     "'r'   - Reset All Parameters\n" 
-     "'CURSOR ARROWS' - Rotate Visuals\n" 
+     "'-/=/b' - Increase/Decrease Speed/Pitch / Reverse, Drag Mouse to Scratch\n" 
+     "'m/r' - Mute Output Audio / Reset All Parameters, 'SPACE/n' - Start-Stop / Power\n" 
+     "'[/]' - Seek Back/Forward 1s, '{/}' 10s, '0' to Start\n" 
+     "'g/v/p' - Groove Trails / Cycle Rings: Mix, L-R, Mid-Side, Decks / Track Overview\n" 
+     "'CURSOR ARROWS' - Rotate Visuals, 'TAB' - Select Deck, 'z/x/c' - Crossfade to A/B/Center\n" 
      "'q'   - Quit\n" 
      "----------------------------------------------------\n" 
      "\n" );
@@ -300,51 +1560,61 @@ static int paCallback( const void *inputBuffer,
         const PaStreamCallbackTimeInfo* timeInfo,
         PaStreamCallbackFlags statusFlags, void *userData ) 
 {
-    /* Cast Appropriate Types and Define Some Useful Variables */
+    double start;
+
     (void) inputBuffer;
-    float* out = (float*)outputBuffer;
-    paData *data = (paData*)userData;
-    int i, numberOfFrames, numInFrames;
 
-    /* This if Statement Ensures Smooth VariSpeed Output */
-    if (fmod((double)framesPerBuffer, data->src_data.src_ratio) == 0)
+    /* Name This Thread Once so the Main Thread Can Promote it */
+    if (!atomic_load_explicit(&g_audio_thread_known, memory_order_relaxed))
     {
-    	numInFrames = framesPerBuffer;
+        g_audio_thread = pthread_self();
+        atomic_store_explicit(&g_audio_thread_known, true, memory_order_release);
     }
-    else
-    	numInFrames = (framesPerBuffer/data->src_data.src_ratio) + 2;
 
-    /* Read FramesPerBuffer Amount of Data from inFile into buffer[] */
-    numberOfFrames = sf_readf_float(data->inFile, data->src_inBuffer, numInFrames);
-
-    /* Looping of inFile if EOF is Reached */
-    if (numberOfFrames < framesPerBuffer/data->src_data.src_ratio) 
-    {
-        sf_seek(data->inFile, 0, SEEK_SET);
+    /* Note Device Glitches, Formatted Later Off This Thread */
+    if (statusFlags & paOutputUnderflow) {
+        postEvent(LOG_OUTPUT_UNDERFLOW, 0, ((paData*)userData)->cache.position);
+    }
+    if (statusFlags & paOutputOverflow) {
+        postEvent(LOG_OUTPUT_OVERFLOW, 0, ((paData*)userData)->cache.position);
     }
 
-    /* Inform SRC Data How Many Input Frames To Process */
-    data->src_data.input_frames = numberOfFrames;
-    data->src_data.end_of_input = 0;
+    /* Run the Whole Chain Straight Into the Device Buffer, Timed for the Governor */
+    start = getTimeSeconds();
+    automationProcess((paData*)userData, (float*)outputBuffer, framesPerBuffer);
+    governorObserve(&((paData*)userData)->governor, getTimeSeconds() - start,
+                    ((paData*)userData)->cache.position);
 
-    /* Perform SRC Modulation, Processed Samples are in src_outBuffer[] */
-    if ((data->src_error = src_process (data->src_state, &data->src_data))) {   
-        printf ("\nError : %s\n\n", src_strerror (data->src_error)) ;
-        exit (1);
-    }
+    /* Both Decks Share the Deadline, so Deck B Follows Deck A's Converter */
+    deckB.governor.target = ((paData*)userData)->governor.target;
 
-    /* Perform Lowpass Filtering */
-    if (data->lpf_On == true) {
-        lowPassFilter(data->src_outBuffer, data->sfinfo1.channels);
-    }
+    /* New Snapshot for the Renderer */
+    atomic_fetch_add_explicit(&g_audio_sequence, 1, memory_order_release);
+    return 0;
+}
 
-    /* Perform Highpass Filtering */
-    if (data->hpf_On == true) {
-        highPassFilter(data->src_outBuffer, data->sfinfo1.channels);
+//-----------------------------------------------------------------------------
+// Name: processAudio( )
+// Desc: Reads, Resamples, Filters, Limits and Meters One Block Into out[].
+//       Shared by the PortAudio Callback and the Offline Exporter.
+//-----------------------------------------------------------------------------
+void processAudio(paData *data, float *out, unsigned long framesPerBuffer)
+{
+    int i;
+
+    /* Two Decks Meet at the Crossfader Instead */
+    if (deckB.inFile != NULL)
+    {
+        mixDecks(data, out, framesPerBuffer);
+        return;
     }
 
-    /* Prevent Blowing Out the Speakers Hopefully */
-    brickwall(data->src_outBuffer, data->sfinfo1.channels);
+    /* Reads, Resamples and Filters Into src_outBuffer */
+    deckProcess(data, framesPerBuffer);
+
+    /* The Renderer Sees the Deck Before the Volume Knob and the Limiter,
+       Same as Each of Two Decks */
+    deckVisualsWrite(data, framesPerBuffer);
 
     // printf("%ld, %ld\n",data->src_data.output_frames_gen, data->src_data.input_frames_used);
 
@@ -354,70 +1624,695 @@ static int paCallback( const void *inputBuffer,
         out[i] = data->src_outBuffer[i] * data->amplitude;
     }
 
-    g_ready = true;
-    return 0;
+    /* Prevent Blowing Out the Speakers */
+    brickwall(&data->limiter, out, framesPerBuffer);
+
+    /* Meter What Actually Goes to the DAC */
+    loudnessMeterProcess(&data->meter, out, framesPerBuffer);
 }
 
 //-----------------------------------------------------------------------------
-// Name: initialize_audio()
-// Desc: Initializes PortAudio With Globals
+// Name: deckVisualsWrite( )
+// Desc: The Renderer's Tap on One Deck: its Filtered src_outBuffer, Before
+//       Volume, Crossfader and Limiter. Deck A's Envelope Scales the Rings.
 //-----------------------------------------------------------------------------
-void initialize_audio(const char* inFile) 
+void deckVisualsWrite(paData *data, unsigned long framesPerBuffer)
 {
-    PaStreamParameters outputParameters;
-    PaError err;
+    envelopeFollowerProcess(&data->envelope, data->src_outBuffer, (int)framesPerBuffer);
+    channelHistoryWrite(&data->history, data->src_outBuffer, (int)framesPerBuffer);
+}
 
-    /* Open the audio file */
-    if (( data.inFile = sf_open( inFile, SFM_READ, &data.sfinfo1 )) == NULL ) 
+//-----------------------------------------------------------------------------
+// Name: deckProcess( )
+// Desc: One Deck's Share of a Block: Reads, Resamples and Filters Into its
+//       src_outBuffer. Touches Nothing Outside That Deck, so Two Can Run at Once.
+//-----------------------------------------------------------------------------
+void deckProcess(paData *data, unsigned long framesPerBuffer)
+{
+    int numberOfFrames, numInFrames;
+
+    /* Live Playback Turns the Platter Over the Cache */
+    if (data->cache.running)
     {
-        printf("Error, Couldn't Open The File\n");
-        exit (1);
+        platterProcess(data, framesPerBuffer);
     }
-
-    /* Check for Compatibility */
-    if (data.sfinfo1.channels > 2)
+    else if (fabs(data->src_ratio - 1.0) < BYPASS_TOLERANCE)
     {
-    	printf("Error, File Must be Stereo or Mono\n");
-        exit (1);
+        /* Unity Speed, the File Decodes Straight Into the Output Buffer */
+        numberOfFrames = sf_readf_float(data->inFile, data->src_outBuffer, framesPerBuffer);
+        atomic_fetch_add_explicit(&data->playhead, numberOfFrames, memory_order_relaxed);
+
+        /* Looping of inFile, the Rest of the Block Comes From the Top */
+        if (numberOfFrames < (int)framesPerBuffer)
+        {
+            sf_seek(data->inFile, 0, SEEK_SET);
+            numInFrames = sf_readf_float(data->inFile, data->src_outBuffer + numberOfFrames * data->sfinfo1.channels,
+                                         framesPerBuffer - numberOfFrames);
+            atomic_store_explicit(&data->playhead, numInFrames, memory_order_relaxed);
+        }
     }
+    else
+    {
+        /* This if Statement Ensures Smooth VariSpeed Output */
+        data->src_data.src_ratio = data->src_ratio;
+        if (fmod((double)framesPerBuffer, data->src_data.src_ratio) == 0)
+        {
+        	numInFrames = framesPerBuffer;
+        }
+        else
+        	numInFrames = (framesPerBuffer/data->src_data.src_ratio) + 2;
 
-    /* Print info about audio file */
-    printf("\nAudio File: %s\nFrames: %d\nSamples: %d\nChannels: %d\nSampleRate: %d\n",
-            inFile, (int)data.sfinfo1.frames, (int)data.sfinfo1.frames * (int)data.sfinfo1.channels,
-            (int)data.sfinfo1.channels, (int)data.sfinfo1.samplerate);
+        /* Read FramesPerBuffer Amount of Data from inFile into buffer[] */
+        numberOfFrames = sf_readf_float(data->inFile, data->src_inBuffer, numInFrames);
+        atomic_fetch_add_explicit(&data->playhead, numberOfFrames, memory_order_relaxed);
 
-    /* Initialize PortAudio */
-    Pa_Initialize();
+        /* Looping of inFile if EOF is Reached */
+        if (numberOfFrames < framesPerBuffer/data->src_data.src_ratio) 
+        {
+            sf_seek(data->inFile, 0, SEEK_SET);
+            atomic_store_explicit(&data->playhead, 0, memory_order_relaxed);
+        }
 
-    /* Set output stream parameters */
-    outputParameters.device = Pa_GetDefaultOutputDevice();
-    outputParameters.channelCount = data.sfinfo1.channels;
-    outputParameters.sampleFormat = paFloat32;
-    outputParameters.suggestedLatency = 
-        Pa_GetDeviceInfo( outputParameters.device )->defaultLowOutputLatency;
-    outputParameters.hostApiSpecificStreamInfo = NULL;
+        /* Inform SRC Data How Many Input Frames To Process, and How Many to Make */
+        data->src_data.input_frames = numberOfFrames;
+        data->src_data.output_frames = framesPerBuffer;
+        data->src_data.end_of_input = 0;
 
-    /* Initialize SRC */
-    if ((data.src_state = src_new (data.src_converter_type, data.sfinfo1.channels, &data.src_error )) == NULL) 
-    {   
-        printf ("Error, SRC Initialization Failed\n");
-        exit (1);
+        /* Perform SRC Modulation, Processed Samples are in src_outBuffer[] */
+        if ((data->src_error = src_process (data->src_state, &data->src_data)))
+        {
+            /* Carry On With a Silent Block Rather Than Stopping the Stream */
+            postEvent(LOG_SRC_ERROR, data->src_error << 16 | (int)framesPerBuffer,
+                      atomic_load_explicit(&data->playhead, memory_order_relaxed));
+            memset(data->src_outBuffer, 0, framesPerBuffer * data->sfinfo1.channels * sizeof(float));
+            src_reset(data->src_state);
+        }
+        else
+        {
+            /* Short Output Plays Silence, Not the Last Block's Tail */
+            memset(data->src_outBuffer + data->src_data.output_frames_gen * data->sfinfo1.channels, 0,
+                   (framesPerBuffer - data->src_data.output_frames_gen) * data->sfinfo1.channels * sizeof(float));
+        }
     }
 
-    /* Sets Up The SRC_DATA Struct */
-    initialize_SRC_DATA();
+    /* Perform Lowpass and Highpass Filtering, Oversampled Near Nyquist */
+    filterProcess(data, framesPerBuffer);
+}
 
-    /* Sets Up Filters */
-    initialize_Filters();
+//-----------------------------------------------------------------------------
+// Name: mixDecks( )
+// Desc: Deck B Runs on its Worker While This Thread Runs Deck A, They Meet
+//       at the End of the Block. Each Deck's Volume and its Side of an
+//       Equal-Power Crossfader, Gliding From the Last Block's Position,
+//       Scale it Into the Mix, Which Then Goes Through the Limiter and Meters.
+//-----------------------------------------------------------------------------
+void mixDecks(paData *data, float *out, unsigned long framesPerBuffer)
+{
+    float  gainsA[FRAMES_PER_BUFFER], gainsB[FRAMES_PER_BUFFER];
+    double angle = data->crossfader * PI / 2, a = cos(angle), b = sin(angle), t;
+    int    i, n = (int)framesPerBuffer;
 
-    /* Set Initial Amplitude */
-    data.amplitude = INITIAL_VOLUME;
+    /* Both Decks at Once, Each Keeps its Own Ring */
+    deckWorkerPost(&g_deck_worker, framesPerBuffer);
+    deckProcess(data, framesPerBuffer);
+    deckVisualsWrite(data, framesPerBuffer);
+    deckWorkerWait(&g_deck_worker);
 
-    /* Open audio stream */
-    err = Pa_OpenStream( &g_stream,
-            NULL,
-            &outputParameters,
-            data.sfinfo1.samplerate, 
+    for (i = 0; i < n; i++)
+    {
+        t = (i + 1.0) / n;
+        gainsA[i] = (float)((data->mixGains[0] + (a - data->mixGains[0]) * t) * data->amplitude);
+        gainsB[i] = (float)((data->mixGains[1] + (b - data->mixGains[1]) * t) * deckB.amplitude);
+    }
+    data->mixGains[0] = a;
+    data->mixGains[1] = b;
+    mixSIMD(data->src_outBuffer, deckB.src_outBuffer, gainsA, gainsB, n, data->sfinfo1.channels);
+
+    /* Prevent Blowing Out the Speakers, Volumes are Already in */
+    brickwall(&data->limiter, data->src_outBuffer, n);
+    memcpy(out, data->src_outBuffer, (size_t)n * data->sfinfo1.channels * sizeof(float));
+    loudnessMeterProcess(&data->meter, out, n);
+}
+
+//-----------------------------------------------------------------------------
+// Name: platterProcess( )
+// Desc: Turntable Inertia. The Motor, its Brake, Bearing Friction or a Hand
+//       Pull the Platter Toward a Target Speed With Constant Torque, so Speed
+//       Ramps Linearly Sample by Sample. Settled at Exactly Normal Speed the
+//       Resampler Would Only Copy, so Frames Come Straight From the Cache.
+//       Entering or Leaving That Bypass, and Switching Converters for the
+//       Governor, Run Both Paths for One Block and Crossfade Between Them.
+//-----------------------------------------------------------------------------
+void platterProcess(paData *data, unsigned long framesPerBuffer)
+{
+    int    direction, numChannels = data->sfinfo1.channels;
+    double target, seconds, step;
+    srcGovernor *g = &data->governor;
+    frameCache  *c = &data->cache;
+    bool   unity, fading, entering;
+    sf_count_t from = 0;
+
+    /* What the Platter is Being Pulled Toward, and How Hard */
+    if (atomic_load_explicit(&data->scratching, memory_order_relaxed))
+    {
+        target  = atomic_load_explicit(&data->scratchSpeed, memory_order_relaxed);
+        seconds = PLATTER_HAND_SECONDS;
+    }
+    else if (data->motor == PLATTER_MOTOR_ON)
+    {
+        target  = data->direction / data->src_ratio;
+        seconds = PLATTER_START_SECONDS;
+    }
+    else
+    {
+        target  = 0;
+        seconds = data->motor == PLATTER_MOTOR_BRAKE ? PLATTER_BRAKE_SECONDS : PLATTER_COAST_SECONDS;
+    }
+    if (fabs(target) > PLATTER_MAX_SPEED) {
+        target = target < 0 ? -PLATTER_MAX_SPEED : PLATTER_MAX_SPEED;
+    }
+    step      = 1.0 / (seconds * data->sfinfo1.samplerate);    // Speed Change per Frame
+    unity     = data->speed == target && fabs(fabs(target) - 1.0) < BYPASS_TOLERANCE;
+    direction = data->speed < 0 ? -1 : 1;
+
+    if (data->bypassed)
+    {
+        /* No Converter is Playing, so the Governor's Choice Costs Nothing */
+        if (g->target != g->level)
+        {
+            g->level        = g->target;
+            data->src_state = g->states[g->level];
+        }
+
+        if (unity)
+        {
+            frameCacheRead(c, data->src_outBuffer, framesPerBuffer, direction);
+            frameCacheAdvance(c, direction * (int)framesPerBuffer);
+        }
+        else
+        {
+            /* Leaving: the Copy Carries on Underneath While the Resampler Fades In,
+               Both at Normal Speed or They Drift Apart Within the Block */
+            frameCachePeek(c, data->fadeBuffer, c->position, framesPerBuffer, direction);
+            if (primeConverter(data, data->src_state))
+            {
+                frameCacheAdvance(c, (int)(g->position - c->position));
+                g->fresh = false;
+            }
+            else
+            {
+                src_reset(data->src_state);
+                g->fresh = true;
+            }
+            platterResample(data, framesPerBuffer, data->speed, step, NULL);    // Ramp Waits a Block
+            crossfade(data->src_outBuffer, data->fadeBuffer, data->src_outBuffer, framesPerBuffer, numChannels);
+            data->bypassed = false;
+        }
+    }
+    else
+    {
+        /* Governor Asked for Another Converter, Bring it Up Alongside This One */
+        fading = g->target != g->level && governorPrime(data);
+
+        /* Entering: Copy From the Frame the Resampler Plays Next */
+        entering = unity && g->target == g->level;
+        if (entering)
+        {
+            from = g->origin + direction * llrint(g->heard);
+            frameCachePeek(c, data->fadeBuffer, from, framesPerBuffer, direction);
+        }
+
+        /* Seeks Mid-Block Leave the Other Path Behind, Try Next Block */
+        if (platterResample(data, framesPerBuffer, target, step, fading ? g->states[g->target] : NULL))
+        {
+            if (fading)
+            {
+                crossfade(data->src_outBuffer, data->src_outBuffer, data->fadeBuffer, framesPerBuffer, numChannels);
+                frameCacheAdvance(c, (int)(g->position - c->position));
+                g->level        = g->target;
+                data->src_state = g->states[g->level];
+            }
+            else if (entering)
+            {
+                crossfade(data->src_outBuffer, data->src_outBuffer, data->fadeBuffer, framesPerBuffer, numChannels);
+                frameCacheAdvance(c, (int)(from + direction * (sf_count_t)framesPerBuffer - c->position));
+                data->bypassed = true;
+            }
+        }
+    }
+
+    /* Bypassed, the Next Output Frame is the Playhead */
+    if (data->bypassed)
+    {
+        g->origin = c->position;
+        g->heard  = 0;
+    }
+
+    atomic_store_explicit(&data->playhead, wrapFrame(c->position, c->fileFrames), memory_order_relaxed);
+}
+
+//-----------------------------------------------------------------------------
+// Name: platterResample( )
+// Desc: While the Platter Moves the Block is Resampled in PLATTER_SUBBLOCK
+//       Pieces, Each Handing libsamplerate the Ratio at its Last Frame so it
+//       Interpolates From last_ratio Across the Piece. A Steady Platter Costs
+//       One src_process Call per Block. An incoming Converter Primed by the
+//       Governor Runs on the Same Pieces Into fadeBuffer. Returns false When
+//       a Seek, Reversal or Error Broke Continuity With the Other Path.
+//-----------------------------------------------------------------------------
+bool platterResample(paData *data, unsigned long framesPerBuffer, double target, double step, SRC_STATE *incoming)
+{
+    int    done, n, numInFrames, direction, numChannels = data->sfinfo1.channels;
+    double lastRatio;
+    srcGovernor *g = &data->governor;
+    bool   continuous = true;
+
+    for (done = 0; done < (int)framesPerBuffer; done += n)
+    {
+        n = framesPerBuffer - done;
+        if (data->speed != target && n > PLATTER_SUBBLOCK) {
+            n = PLATTER_SUBBLOCK;
+        }
+
+        /* Speed at the Last Frame of This Piece */
+        if (fabs(target - data->speed) <= step * n) {
+            data->speed = target;
+        }
+        else {
+            data->speed += target > data->speed ? step * n : -step * n;
+        }
+
+        /* Record Held Still, Nothing Moves Under the Needle */
+        if (fabs(data->speed) < PLATTER_MIN_SPEED)
+        {
+            memset(data->src_outBuffer + done * numChannels, 0, n * numChannels * sizeof(float));
+            memset(data->fadeBuffer + done * numChannels, 0, n * numChannels * sizeof(float));
+            continue;
+        }
+
+        /* Read Enough for Whichever End of the Ratio Sweep Runs Faster */
+        lastRatio   = data->src_data.src_ratio;
+        data->src_data.src_ratio = 1.0 / fabs(data->speed);
+        numInFrames = n / fmin(lastRatio, data->src_data.src_ratio) + 2;
+        direction   = data->speed < 0 ? -1 : 1;
+
+        /* Resampler History Belongs to the Old Position After a Seek or Reversal */
+        if (frameCacheRead(&data->cache, data->src_inBuffer, numInFrames, direction))
+        {
+            src_reset(data->src_state);
+            g->origin  = data->cache.position;
+            g->heard   = 0;
+            g->fresh   = true;
+            continuous = false;
+        }
+
+        data->src_data.data_out      = data->src_outBuffer + done * numChannels;
+        data->src_data.output_frames = n;
+        data->src_data.input_frames  = numInFrames;
+        data->src_data.end_of_input  = 0;
+
+        if ((data->src_error = src_process (data->src_state, &data->src_data)))
+        {
+            /* Silence This Piece and Start the Resampler Over, Playhead Stays */
+            postEvent(LOG_SRC_ERROR, data->src_error << 16 | n, data->cache.position);
+            memset(data->src_outBuffer + done * numChannels, 0, n * numChannels * sizeof(float));
+            src_reset(data->src_state);
+            g->origin  = data->cache.position;
+            g->heard   = 0;
+            g->fresh   = true;
+            continuous = false;
+            continue;
+        }
+
+        /* Too Little Input for the Sinc Window, as When Nearly Still, Plays Silence
+           Rather Than What the Last Block Left There */
+        memset(data->src_outBuffer + (done + data->src_data.output_frames_gen) * numChannels, 0,
+               (n - data->src_data.output_frames_gen) * numChannels * sizeof(float));
+
+        /* Frames the Resampler Left Unused are Read Again Next Time */
+        frameCacheAdvance(&data->cache, direction * data->src_data.input_frames_used);
+        g->heard += data->src_data.output_frames_gen
+                  / (g->fresh ? data->src_data.src_ratio : 0.5 * (lastRatio + data->src_data.src_ratio));
+        g->fresh  = false;
+
+        /* Incoming Converter Reads its Own Position, Lined Up With the Output */
+        if (incoming != NULL && continuous)
+        {
+            frameCachePeek(&data->cache, g->input, g->position, numInFrames, direction);
+            g->block.data_out      = data->fadeBuffer + done * numChannels;
+            g->block.src_ratio     = data->src_data.src_ratio;
+            g->block.input_frames  = numInFrames;
+            g->block.output_frames = n;
+            continuous = src_process(incoming, &g->block) == 0;
+            if (continuous) {
+                memset(data->fadeBuffer + (done + g->block.output_frames_gen) * numChannels, 0,
+                       (n - g->block.output_frames_gen) * numChannels * sizeof(float));
+            }
+            g->position += direction * g->block.input_frames_used;
+            g->block.data_out = g->output;
+        }
+    }
+
+    data->src_data.data_out      = data->src_outBuffer;
+    data->src_data.output_frames = FRAMES_PER_BUFFER;
+    return continuous;
+}
+
+//-----------------------------------------------------------------------------
+// Name: crossfade( )
+// Desc: Linear Over numFrames, From Fully from to Fully to. dst May Be Either.
+//-----------------------------------------------------------------------------
+static void crossfade(float *dst, const float *from, const float *to, int numFrames, int numChannels)
+{
+    float gain;
+    int   i, k;
+
+    for (i = 0; i < numFrames; i++)
+    {
+        gain = (float)(i + 1) / numFrames;
+        for (k = 0; k < numChannels; k++) {
+            dst[i * numChannels + k] = from[i * numChannels + k]
+                                     + gain * (to[i * numChannels + k] - from[i * numChannels + k]);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name: initialize_governor()
+// Desc: Opens a Converter for Every Rung From the Calibrated One Down, so a
+//       Downgrade Never Allocates on the Audio Thread
+//-----------------------------------------------------------------------------
+void initialize_governor(srcGovernor *g, int converterType, int numChannels, int sampleRate)
+{
+    int i, error;
+
+    memset(g, 0, sizeof(*g));
+    for (i = 0; i < GOVERNOR_LEVELS; i++)
+    {
+        if (srcLadder[i] == converterType) {
+            g->ceiling = i;
+        }
+    }
+
+    g->block.data_in  = g->input;
+    g->block.data_out = g->output;
+
+    for (i = g->ceiling; i < GOVERNOR_LEVELS; i++)
+    {
+        if ((g->states[i] = src_new(srcLadder[i], numChannels, &error)) == NULL)
+        {
+            printf("Error, SRC Initialization Failed\n");
+            exit(1);
+        }
+    }
+
+    g->level    = g->target = g->measured = g->ceiling;
+    g->fresh    = true;
+    atomic_store_explicit(&g->playing, g->level, memory_order_relaxed);
+    g->deadline = (double)FRAMES_PER_BUFFER / sampleRate;
+}
+
+//-----------------------------------------------------------------------------
+// Name: governorObserve()
+// Desc: Audio Thread, After Each Callback. Keeps a Moving p99 of Callback
+//       Durations in a Histogram of the Last GOVERNOR_WINDOW Blocks, Steps
+//       One Converter Down When it Nears the Deadline and Back Up After a
+//       Stretch of Headroom, Never Above the Calibrated Choice.
+//-----------------------------------------------------------------------------
+void governorObserve(srcGovernor *g, double seconds, sf_count_t position)
+{
+    int bin, p99, count, limit;
+
+    /* The Crossfade Block Ran Two Converters, and the Old Window Described Another */
+    if (g->measured != g->level)
+    {
+        g->measured = g->level;
+        g->filled = g->next = g->calm = 0;
+        memset(g->histogram, 0, sizeof(g->histogram));
+        return;
+    }
+
+    bin = (int)(100.0 * seconds / g->deadline);
+    if (bin >= GOVERNOR_BINS) {
+        bin = GOVERNOR_BINS - 1;
+    }
+    if (g->filled == GOVERNOR_WINDOW) {
+        g->histogram[g->recent[g->next]]--;
+    }
+    else {
+        g->filled++;
+    }
+    g->recent[g->next] = bin;
+    g->histogram[bin]++;
+    g->next = (g->next + 1) % GOVERNOR_WINDOW;
+
+    if (++g->checks < GOVERNOR_CHECK_BLOCKS) {
+        return;
+    }
+    g->checks = 0;
+
+    /* Highest Bin Once the Slowest 1% are Set Aside */
+    limit = g->filled - (int)ceil(g->filled * GOVERNOR_PERCENTILE);
+    for (p99 = GOVERNOR_BINS - 1, count = 0; p99 > 0; p99--)
+    {
+        if ((count += g->histogram[p99]) > limit) {
+            break;
+        }
+    }
+    atomic_store_explicit(&g->p99, p99, memory_order_relaxed);
+    atomic_store_explicit(&g->playing, g->level, memory_order_relaxed);
+
+    /* Judge Only a Settled Converter With a Quarter Window Behind it */
+    if (g->filled < GOVERNOR_WINDOW / 4 || g->target != g->level) {
+        return;
+    }
+
+    if (p99 >= GOVERNOR_HIGH && g->level < GOVERNOR_LEVELS - 1)
+    {
+        g->target = g->level + 1;
+        postEvent(LOG_SRC_DOWNGRADE, srcLadder[g->target] << 8 | p99, position);
+    }
+    else if (p99 <= GOVERNOR_LOW && g->level > g->ceiling)
+    {
+        if ((g->calm += GOVERNOR_CHECK_BLOCKS) >= GOVERNOR_UP_BLOCKS)
+        {
+            g->target = g->level - 1;
+            postEvent(LOG_SRC_UPGRADE, srcLadder[g->target] << 8 | p99, position);
+        }
+    }
+    else {
+        g->calm = 0;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name: primeConverter()
+// Desc: Audio Thread. Sinc Converters Buffer However Much Input They are
+//       Offered, so Consumed Frames Say Nothing About What Plays Next. A
+//       Converter Joining Mid-Stream Instead Starts a Whole Number of Output
+//       Frames Before the Instant Playing Next, and Those are Thrown Away.
+//       Its Input Resumes From g->position. Returns false When Nothing Can
+//       Line Up: a Pending Seek, a Reversal, a Stopped Platter or an Error.
+//-----------------------------------------------------------------------------
+bool primeConverter(paData *data, SRC_STATE *state)
+{
+    srcGovernor *g = &data->governor;
+    frameCache  *c = &data->cache;
+    double ratio;
+    int    direction, discard;
+    sf_count_t start;
+
+    src_reset(state);
+    direction = data->speed < 0 ? -1 : 1;
+
+    if (fabs(data->speed) < PLATTER_MIN_SPEED
+        || atomic_load_explicit(&c->seekPublished, memory_order_acquire) != c->seekSeen
+        || direction != atomic_load_explicit(&c->direction, memory_order_relaxed))
+    {
+        return false;
+    }
+
+    ratio   = 1.0 / fabs(data->speed);
+    discard = (int)fmin(GOVERNOR_PRIME_FRAMES * ratio, FRAMES_PER_BUFFER - 1);
+    start   = g->origin + direction * llrint(g->heard - discard / ratio);
+
+    frameCachePeek(c, g->input, start, discard / ratio + GOVERNOR_LOOKAHEAD, direction);
+    g->block.src_ratio     = ratio;
+    g->block.input_frames  = discard / ratio + GOVERNOR_LOOKAHEAD;
+    g->block.output_frames = discard;
+    g->block.end_of_input  = 0;
+    if (src_process(state, &g->block) != 0 || g->block.output_frames_gen != discard)
+    {
+        src_reset(state);
+        return false;
+    }
+
+    g->position = start + direction * g->block.input_frames_used;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// Name: governorPrime()
+// Desc: Audio Thread. Lines the Governor's Next Converter Up With the One
+//       Playing, or Switches Outright and Returns false When it Cannot.
+//-----------------------------------------------------------------------------
+bool governorPrime(paData *data)
+{
+    srcGovernor *g = &data->governor;
+
+    if (primeConverter(data, g->states[g->target])) {
+        return true;
+    }
+
+    g->level        = g->target;
+    g->origin       = data->cache.position;
+    g->heard        = 0;
+    g->fresh        = true;
+    data->src_state = g->states[g->level];
+    return false;
+}
+
+//-----------------------------------------------------------------------------
+// Name: stop_governor()
+// Desc: Closes Every Converter on the Ladder
+//-----------------------------------------------------------------------------
+void stop_governor(srcGovernor *g)
+{
+    int i;
+
+    for (i = 0; i < GOVERNOR_LEVELS; i++)
+    {
+        if (g->states[i] != NULL) {
+            src_delete(g->states[i]);
+            g->states[i] = NULL;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name: initialize_deck()
+// Desc: Opens inFile on One Deck and Sets Up its Resampler and Filters
+//-----------------------------------------------------------------------------
+void initialize_deck(paData *data, const char* inFile)
+{
+    /* Open the audio file */
+    if (( data->inFile = sf_open( inFile, SFM_READ, &data->sfinfo1 )) == NULL ) 
+    {
+        printf("Error, Couldn't Open The File\n");
+        exit (1);
+    }
+
+    /* Check for Compatibility */
+    if (data->sfinfo1.channels > 2)
+    {
+    	printf("Error, File Must be Stereo or Mono\n");
+        exit (1);
+    }
+
+    /* Print info about audio file */
+    printf("\nAudio File: %s\nFrames: %d\nSamples: %d\nChannels: %d\nSampleRate: %d\n",
+            inFile, (int)data->sfinfo1.frames, (int)data->sfinfo1.frames * (int)data->sfinfo1.channels,
+            (int)data->sfinfo1.channels, (int)data->sfinfo1.samplerate);
+
+    /* Initialize SRC, Every Converter From the Calibrated One Down */
+    initialize_governor(&data->governor, data->src_converter_type, data->sfinfo1.channels, data->sfinfo1.samplerate);
+    data->src_state = data->governor.states[data->governor.level];
+
+    /* Sets Up The SRC_DATA Struct */
+    initialize_SRC_DATA(data);
+
+    /* Sets Up Filters */
+    initialize_Filters(data);
+
+    /* Set Initial Amplitude */
+    data->amplitude = INITIAL_VOLUME;
+
+    /* Sets Up Per-Channel Visual History and Envelopes */
+    initialize_channelHistory(&data->history, data->sfinfo1.channels);
+    initialize_envelopeFollower(&data->envelope, data->sfinfo1.samplerate, data->sfinfo1.channels);
+}
+
+//-----------------------------------------------------------------------------
+// Name: initialize_engine()
+// Desc: Opens the Decks and Sets Up the DSP Chain, Everything but the Device
+//-----------------------------------------------------------------------------
+void initialize_engine(const char* inFile, const char* deckFile) 
+{
+    /* First Deck Also Carries the Output Chain */
+    initialize_deck(&data, inFile);
+
+    /* Second Deck Mixes Into the First Through the Crossfader */
+    if (deckFile != NULL)
+    {
+        deckB.src_converter_type = data.src_converter_type;
+        initialize_deck(&deckB, deckFile);
+        if (deckB.sfinfo1.samplerate != data.sfinfo1.samplerate || deckB.sfinfo1.channels != data.sfinfo1.channels)
+        {
+            printf("Error, Both Decks Need the Same Sample Rate and Channel Count\n");
+            exit (1);
+        }
+        /* Without a Worker Thread (Export) the Callback Plays it Too */
+        g_deck_worker.deck = &deckB;
+
+        data.crossfader  = CROSSFADER_CENTER;
+        data.mixGains[0] = cos(CROSSFADER_CENTER * PI / 2);
+        data.mixGains[1] = sin(CROSSFADER_CENTER * PI / 2);
+    }
+
+    /* Sets Up Output Limiter */
+    initialize_limiter(&data.limiter, data.sfinfo1.samplerate, data.sfinfo1.channels, g_options.lookahead_ms);
+
+    /* Two Decks Default to One Ring Each, One Deck Has no Second Ring to Show */
+    g_ring_mode = g_options.ring_mode;
+    if (deckFile != NULL && g_ring_mode == RING_MODE_MIX) {
+        g_ring_mode = RING_MODE_DECKS;
+    }
+    if (deckFile == NULL && g_ring_mode == RING_MODE_DECKS) {
+        g_ring_mode = RING_MODE_MIX;
+    }
+
+    /* Sets Up Loudness Meter */
+    initialize_loudnessMeter(&data.meter, data.sfinfo1.samplerate, data.sfinfo1.channels);
+}
+
+//-----------------------------------------------------------------------------
+// Name: initialize_audio()
+// Desc: Initializes PortAudio With Globals
+//-----------------------------------------------------------------------------
+void initialize_audio(const char* inFile, const char* deckFile) 
+{
+    PaStreamParameters outputParameters;
+    PaError err;
+
+    /* Open Files and Build the DSP Chain */
+    initialize_engine(inFile, deckFile);
+
+    /* Decode Ahead of the Playhead Before the Callback Runs */
+    initialize_frameCache(&data.cache, inFile, true);
+
+    /* Second Deck Reads on its Own Thread and Plays on Another */
+    if (deckFile != NULL)
+    {
+        initialize_frameCache(&deckB.cache, deckFile, true);
+        initialize_deckWorker(&g_deck_worker);
+    }
+
+    /* Initialize PortAudio */
+    Pa_Initialize();
+
+    /* Set output stream parameters */
+    outputParameters.device = Pa_GetDefaultOutputDevice();
+    outputParameters.channelCount = data.sfinfo1.channels;
+    outputParameters.sampleFormat = paFloat32;
+    outputParameters.suggestedLatency = 
+        Pa_GetDeviceInfo( outputParameters.device )->defaultLowOutputLatency;
+    outputParameters.hostApiSpecificStreamInfo = NULL;
+
+    /* Open audio stream */
+    err = Pa_OpenStream( &g_stream,
+            NULL,
+            &outputParameters,
+            data.sfinfo1.samplerate, 
             FRAMES_PER_BUFFER, 
             paNoFlag, 
             paCallback, 
@@ -433,6 +2328,9 @@ void initialize_audio(const char* inFile)
         printf(  "PortAudio error: start stream: %s\n", Pa_GetErrorText(err));
     }
 
+    /* Priority and Pinning for the Thread PortAudio Just Started */
+    promoteAudioThread();
+
 }
 
 //-----------------------------------------------------------------------------
@@ -464,43 +2362,49 @@ void stop_portAudio()
 // Name: initialize_SRC_DATA()
 // Desc: Sets Up The SRC_DATA Struct to Pass to src_process(SRC_STATE *state, SRC_DATA *data)
 //-----------------------------------------------------------------------------
-void initialize_SRC_DATA()
+void initialize_SRC_DATA(paData *data)
 {
-    data.src_ratio = 1;                             //Sets Default Playback Speed
+    data->src_ratio = 1;                            //Sets Default Playback Speed
+    data->direction = 1;                            //Forwards
+    data->motor = PLATTER_MOTOR_ON;                 //Already Up to Speed
+    data->speed = 1;
     /*---------------*/
-    data.src_data.input_frames = 0;                 //Start with Zero to Force Load
-    data.src_data.data_in = data.src_inBuffer;      //Point to SRC inBuffer
-    data.src_data.data_out = data.src_outBuffer;    //Point to SRC OutBuffer
-    data.src_data.output_frames = FRAMES_PER_BUFFER;//Number of Frames to Write Out
-    data.src_data.src_ratio = data.src_ratio;       //Sets Default Playback Speed
+    data->src_data.input_frames = 0;                //Start with Zero to Force Load
+    data->src_data.data_in = data->src_inBuffer;    //Point to SRC inBuffer
+    data->src_data.data_out = data->src_outBuffer;  //Point to SRC OutBuffer
+    data->src_data.output_frames = FRAMES_PER_BUFFER;//Number of Frames to Write Out
+    data->src_data.src_ratio = data->src_ratio;     //Sets Default Playback Speed
 }
 
 //-----------------------------------------------------------------------------
 // Name: initialize_Filters()
 // Desc: Sets Default Filter Settings
 //-----------------------------------------------------------------------------
-void initialize_Filters()
+void initialize_Filters(paData *data)
 {
     /* Lowpass Filter */
-    data.lpf_On   = false;  //Default Off
-    data.lpf_freq = 20000;  //Max Open
-    data.lpf_res  = 1;      //No Resonance
+    data->lpf_On   = false; //Default Off
+    data->lpf_freq = 20000; //Max Open
+    data->lpf_res  = 1;     //No Resonance
 
     /* Highpass Filter */
-    data.hpf_On   = false;  //Default Off
-    data.hpf_freq = 20;     //Max Closed
-    data.hpf_res  = 1;      //No Resonance
+    data->hpf_On   = false; //Default Off
+    data->hpf_freq = 20;    //Max Closed
+    data->hpf_res  = 1;     //No Resonance
 
     /* Define Off/On */
-    data.filterState[0] = "Off";
-    data.filterState[1] = "On";    
+    data->filterState[0] = "Off";
+    data->filterState[1] = "On";    
+
+    /* Halfband Stages for High Cutoffs */
+    initialize_oversampler(&data->oversampler);
 }
 
 //-----------------------------------------------------------------------------
 // Name: lowPassFilter(float *inBuffer)
 // Desc: Applies 2 Pole lowPassFilter based on http://www.mega-nerd.com/Res/IADSPL/RBJ-filters.txt
 //-----------------------------------------------------------------------------
-static void lowPassFilter(float *inBuffer, int numChannels)
+static void lowPassFilter(paData *data, float *inBuffer, int numFrames, int numChannels, double sampleRate, int freq, int res)
 {
     // Difference Equation
     /* y[n] = (b0/a0)*x[n] + (b1/a0)*x[n-1] + (b2/a0)*x[n-2] - (a1/a0)*y[n-1] - (a2/a0)*y[n-2] */
@@ -510,13 +2414,14 @@ static void lowPassFilter(float *inBuffer, int numChannels)
     float   alpha, omega, cs;
     float   a0, a1, a2, b0, b1, b2;
 
-    /* Account for Transient Response of Filter */
-    static  float   lx1 = 0, lx2 = 0, ly1 = 0, ly2 = 0;
-    static  float   rx1 = 0, rx2 = 0, ry1 = 0, ry2 = 0; 
+    /* Account for Transient Response of Filter, Kept per Deck */
+    float  *state = data->lpfState;
+    float   lx1 = state[0], lx2 = state[1], ly1 = state[2], ly2 = state[3];
+    float   rx1 = state[4], rx2 = state[5], ry1 = state[6], ry2 = state[7];
 
     /* First Compute a Few Intermediate Variables */
-    omega = 2.0 * PI * data.lpf_freq / data.sfinfo1.samplerate;
-    alpha = sin(omega) / (2.0 * data.lpf_res);
+    omega = 2.0 * PI * freq / sampleRate;
+    alpha = sin(omega) / (2.0 * res);
     cs    = cos(omega);
 
     /* Calcuate Filter Coefficients */
@@ -530,7 +2435,7 @@ static void lowPassFilter(float *inBuffer, int numChannels)
     /* Lowpass the Chunk of Data for Mono */
     if (numChannels == MONO)
     {
-    	for (i = 0; i < FRAMES_PER_BUFFER; i++)
+    	for (i = 0; i < numFrames; i++)
     	{
         	/* Run a Sample Through the Difference Equation */
         	processed_sample = (b0/a0) * inBuffer[i] + (b1/a0) * lx1 + (b2/a0) * lx2 - 
@@ -555,7 +2460,7 @@ static void lowPassFilter(float *inBuffer, int numChannels)
     else if (numChannels == STEREO)
     {
     	/* Left Channel */
-    	for (i = 0; i < FRAMES_PER_BUFFER; i++)
+    	for (i = 0; i < numFrames; i++)
     	{
         	processed_sample = (b0/a0) * inBuffer[2*i] + (b1/a0) * lx1 + (b2/a0) * lx2 - 
                            (a1/a0) * ly1 - (a2/a0) * ly2;
@@ -573,7 +2478,7 @@ static void lowPassFilter(float *inBuffer, int numChannels)
     	}
 
     	/* Right Channel */
-    	for (i = 0; i < FRAMES_PER_BUFFER; i++)
+    	for (i = 0; i < numFrames; i++)
     	{
         	processed_sample = (b0/a0) * inBuffer[2*i+1] + (b1/a0) * rx1 + (b2/a0) * rx2 - 
                            (a1/a0) * ry1 - (a2/a0) * ry2;
@@ -591,13 +2496,17 @@ static void lowPassFilter(float *inBuffer, int numChannels)
     	}
     }
 
+    /* Carry the Histories Into the Next Block */
+    state[0] = lx1; state[1] = lx2; state[2] = ly1; state[3] = ly2;
+    state[4] = rx1; state[5] = rx2; state[6] = ry1; state[7] = ry2;
+
 }
 
 //-----------------------------------------------------------------------------
 // Name: highPassFilter(float *inBuffer)
 // Desc: Applies 2 Pole highPassFilter based on http://www.mega-nerd.com/Res/IADSPL/RBJ-filters.txt
 //-----------------------------------------------------------------------------
-static void highPassFilter(float *inBuffer, int numChannels)
+static void highPassFilter(paData *data, float *inBuffer, int numFrames, int numChannels, double sampleRate, int freq, int res)
 {
     // Difference Equation
     /* y[n] = (b0/a0)*x[n] + (b1/a0)*x[n-1] + (b2/a0)*x[n-2] - (a1/a0)*y[n-1] - (a2/a0)*y[n-2] */
@@ -607,13 +2516,14 @@ static void highPassFilter(float *inBuffer, int numChannels)
     float   alpha, omega, cs;
     float   a0, a1, a2, b0, b1, b2;
 
-    /* Account for Transient Response of Filter */
-    static  float   lx1 = 0, lx2 = 0, ly1 = 0, ly2 = 0;
-    static  float   rx1 = 0, rx2 = 0, ry1 = 0, ry2 = 0; 
+    /* Account for Transient Response of Filter, Kept per Deck */
+    float  *state = data->hpfState;
+    float   lx1 = state[0], lx2 = state[1], ly1 = state[2], ly2 = state[3];
+    float   rx1 = state[4], rx2 = state[5], ry1 = state[6], ry2 = state[7];
 
     /* First Compute a Few Intermediate Variables */
-    omega = 2.0 * PI * data.hpf_freq / data.sfinfo1.samplerate;
-    alpha = sin(omega) / (2.0 * data.hpf_res);
+    omega = 2.0 * PI * freq / sampleRate;
+    alpha = sin(omega) / (2.0 * res);
     cs    = cos(omega);
 
     /* Calcuate Filter Coefficients */
@@ -627,7 +2537,7 @@ static void highPassFilter(float *inBuffer, int numChannels)
     /* Highpass the Chunk of Data for Mono */
     if (numChannels == MONO)
     {
-    	for (i = 0; i < FRAMES_PER_BUFFER; i++)
+    	for (i = 0; i < numFrames; i++)
     	{
         	/* Run a Sample Through the Difference Equation */
         	processed_sample = (b0/a0) * inBuffer[i] + (b1/a0) * lx1 + (b2/a0) * lx2 - 
@@ -652,7 +2562,7 @@ static void highPassFilter(float *inBuffer, int numChannels)
     else if (numChannels == STEREO)
     {
     	/* Left Channel */
-    	for (i = 0; i < FRAMES_PER_BUFFER; i++)
+    	for (i = 0; i < numFrames; i++)
     	{
         	processed_sample = (b0/a0) * inBuffer[2*i] + (b1/a0) * lx1 + (b2/a0) * lx2 - 
                            (a1/a0) * ly1 - (a2/a0) * ly2;
@@ -670,7 +2580,7 @@ static void highPassFilter(float *inBuffer, int numChannels)
     	}
 
     	/* Right Channel */
-    	for (i = 0; i < FRAMES_PER_BUFFER; i++)
+    	for (i = 0; i < numFrames; i++)
     	{
         	processed_sample = (b0/a0) * inBuffer[2*i+1] + (b1/a0) * rx1 + (b2/a0) * rx2 - 
                            (a1/a0) * ry1 - (a2/a0) * ry2;
@@ -687,190 +2597,553 @@ static void highPassFilter(float *inBuffer, int numChannels)
         	inBuffer[2*i+1] = processed_sample;
     	}
     }
+
+    /* Carry the Histories Into the Next Block */
+    state[0] = lx1; state[1] = lx2; state[2] = ly1; state[3] = ly2;
+    state[4] = rx1; state[5] = rx2; state[6] = ry1; state[7] = ry2;
 }
 
 //-----------------------------------------------------------------------------
-// Name: keyboardFunc( )
-// Desc: key event
+// Name: filterOversampling()
+// Desc: Rate Multiple for the Filters. The Bilinear Transform Squeezes the
+//       Whole Response Into Nyquist, so a Cutoff Near it Comes Out Too Low
+//       and Too Steep. Run Faster and the Same Cutoff Sits Where the
+//       Warping is Mild. Low Cutoffs, or Filters Off, Stay at 1x for Free.
 //-----------------------------------------------------------------------------
-void keyboardFunc( unsigned char key, int x, int y )
+int filterOversampling(paData *data)
 {
+    double highest = 0, rate = data->sfinfo1.samplerate;
+
+    if (data->lpf_On) {
+        highest = data->lpf_freq;
+    }
+    if (data->hpf_On && data->hpf_freq > highest) {
+        highest = data->hpf_freq;
+    }
+
+    if (highest > OVERSAMPLE_4X_CUTOFF * rate) {
+        return 4;
+    }
+    if (highest > OVERSAMPLE_2X_CUTOFF * rate) {
+        return 2;
+    }
+    return 1;
+}
+
+//-----------------------------------------------------------------------------
+// Name: delayLine()
+// Desc: One Channel of Interleaved Audio Delayed by length Samples, in Place
+//-----------------------------------------------------------------------------
+static void delayLine(float *line, int length, float *io, int numFrames, int ch, int numChannels)
+{
+    int i;
+
+    if (length == 0) {
+        return;
+    }
+    for (i = 0; i < numFrames; i++) {
+        line[length + i] = io[i * numChannels + ch];
+    }
+    for (i = 0; i < numFrames; i++) {
+        io[i * numChannels + ch] = line[i];
+    }
+    memmove(line, line + numFrames, length * sizeof(float));
+}
+
+//-----------------------------------------------------------------------------
+// Name: filterPathProcess()
+// Desc: block[] Through One Rate's Path: Up, Filters, Down, Plus the Delay
+//       That Gives Every Rate OVERSAMPLE_LATENCY. With Both Filters Off the
+//       1x Path is Only That Delay.
+//-----------------------------------------------------------------------------
+static void filterPathProcess(paData *data, filterPath *p, float *block, int numFrames, const filterSettings *f)
+{
+    oversampler *os = &data->oversampler;
+    int    factor = p->factor, numChannels = data->sfinfo1.channels, ch;
+    float *buffer = block;
+
+    if (factor == 1)
+    {
+        for (ch = 0; ch < numChannels; ch++) {
+            delayLine(p->delay[ch], p->pad, block, numFrames, ch, numChannels);
+        }
+    }
+    else
+    {
+        for (ch = 0; ch < numChannels; ch++)
+        {
+            halfbandUp(&p->stages[0], ch, block, numFrames, os->middle, numChannels, os->fir);
+            delayLine(p->delay[ch], p->pad, os->middle, numFrames * 2, ch, numChannels);
+        }
+        buffer = os->middle;
+        if (factor == 4)
+        {
+            for (ch = 0; ch < numChannels; ch++) {
+                halfbandUp(&p->stages[1], ch, os->middle, numFrames * 2, os->buffer, numChannels, os->fir);
+            }
+            buffer = os->buffer;
+        }
+    }
+
+    /* Perform Lowpass Filtering */
+    if (f->lpfOn) {
+        lowPassFilter(data, buffer, numFrames * factor, numChannels, data->sfinfo1.samplerate * factor, f->lpfFreq, f->lpfRes);
+    }
+
+    /* Perform Highpass Filtering */
+    if (f->hpfOn) {
+        highPassFilter(data, buffer, numFrames * factor, numChannels, data->sfinfo1.samplerate * factor, f->hpfFreq, f->hpfRes);
+    }
+
+    if (factor == 4)
+    {
+        for (ch = 0; ch < numChannels; ch++) {
+            halfbandDown(&p->stages[1], ch, os->buffer, numFrames * 2, os->middle, numChannels, os->fir);
+        }
+    }
+    if (factor > 1)
+    {
+        for (ch = 0; ch < numChannels; ch++) {
+            halfbandDown(&p->stages[0], ch, os->middle, numFrames, block, numChannels, os->fir);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name: filterProcess()
+// Desc: Lowpass Then Highpass on src_outBuffer, Through the Halfband Stages
+//       up to 2x or 4x and Back When filterOversampling() Asks for it. Every
+//       Rate Has the Same Latency, so Changing Rates or Switching a Filter
+//       Brings a Second Path up Alongside, Primed on the Input Just Before
+//       it Like a Converter the Governor Switches to, and Crossfades Into it.
+//       Settings Changes Wait for a Crossfade to Finish.
+//-----------------------------------------------------------------------------
+void filterProcess(paData *data, int numFrames)
+{
+    oversampler *os = &data->oversampler;
+    int    factor = filterOversampling(data), numChannels = data->sfinfo1.channels, ch, i, k;
+    float *block = data->src_outBuffer, state[8], gain;
+    filterSettings now = { data->lpf_On, data->hpf_On, data->lpf_freq, data->lpf_res, data->hpf_freq, data->hpf_res };
+    filterPath *from = &os->paths[os->current], *to;
+
+    /* Kept Before the Block Runs, Priming Reads the Frames Ahead of it */
+    for (ch = 0; ch < numChannels; ch++)
+    {
+        for (i = 0; i < numFrames; i++) {
+            os->input[ch][OVERSAMPLE_PRIME_FRAMES + i] = block[i * numChannels + ch];
+        }
+    }
+
+    if (os->fadeDone == OVERSAMPLE_FADE_FRAMES &&
+        (factor != from->factor || now.lpfOn != os->settings[os->current].lpfOn || now.hpfOn != os->settings[os->current].hpfOn))
+    {
+        /* Outgoing Path Keeps its Settings and Biquads to the End of the Crossfade */
+        memcpy(from->lpfState, data->lpfState, sizeof(data->lpfState));
+        memcpy(from->hpfState, data->hpfState, sizeof(data->hpfState));
+        if (!os->settings[os->current].lpfOn) {
+            memset(data->lpfState, 0, sizeof(data->lpfState));
+        }
+        if (!os->settings[os->current].hpfOn) {
+            memset(data->hpfState, 0, sizeof(data->hpfState));
+        }
+
+        /* Incoming Path's Stages Sat Idle, Fill Them From the Recent Input */
+        os->current = 1 - os->current;
+        to = &os->paths[os->current];
+        os->settings[os->current] = now;
+        to->factor = factor;
+        to->pad    = factor == 1 ? OVERSAMPLE_LATENCY : factor == 2 ? OVERSAMPLE_PAD_2X : OVERSAMPLE_PAD_4X;
+        for (k = 0; k < 2; k++)
+        {
+            memset(to->stages[k].up, 0, sizeof(to->stages[k].up));
+            memset(to->stages[k].even, 0, sizeof(to->stages[k].even));
+            memset(to->stages[k].odd, 0, sizeof(to->stages[k].odd));
+        }
+        memset(to->delay, 0, sizeof(to->delay));
+        for (ch = 0; ch < numChannels; ch++)
+        {
+            for (i = 0; i < OVERSAMPLE_PRIME_FRAMES; i++) {
+                os->prime[i * numChannels + ch] = os->input[ch][i];
+            }
+        }
+        filterPathProcess(data, to, os->prime, OVERSAMPLE_PRIME_FRAMES, &now);
+        os->fadeDone = 0;
+    }
+    else if (os->fadeDone == OVERSAMPLE_FADE_FRAMES) {
+        os->settings[os->current] = now;
+    }
+
+    /* Outgoing Path on a Copy, its Own Biquads Swapped in Around it */
+    if (os->fadeDone < OVERSAMPLE_FADE_FRAMES)
+    {
+        from = &os->paths[1 - os->current];
+        memcpy(os->fade, block, (size_t)numFrames * numChannels * sizeof(float));
+        memcpy(state, data->lpfState, sizeof(state));
+        memcpy(data->lpfState, from->lpfState, sizeof(state));
+        memcpy(from->lpfState, state, sizeof(state));
+        memcpy(state, data->hpfState, sizeof(state));
+        memcpy(data->hpfState, from->hpfState, sizeof(state));
+        memcpy(from->hpfState, state, sizeof(state));
+
+        filterPathProcess(data, from, os->fade, numFrames, &os->settings[1 - os->current]);
+
+        memcpy(state, data->lpfState, sizeof(state));
+        memcpy(data->lpfState, from->lpfState, sizeof(state));
+        memcpy(from->lpfState, state, sizeof(state));
+        memcpy(state, data->hpfState, sizeof(state));
+        memcpy(data->hpfState, from->hpfState, sizeof(state));
+        memcpy(from->hpfState, state, sizeof(state));
+    }
+
+    filterPathProcess(data, &os->paths[os->current], block, numFrames, &os->settings[os->current]);
+
+    /* Linear Over OVERSAMPLE_FADE_FRAMES, However Many Blocks That Takes */
+    if (os->fadeDone < OVERSAMPLE_FADE_FRAMES)
+    {
+        for (i = 0; i < numFrames; i++)
+        {
+            gain = os->fadeDone + i + 1 < OVERSAMPLE_FADE_FRAMES ? (float)(os->fadeDone + i + 1) / OVERSAMPLE_FADE_FRAMES : 1.0f;
+            for (ch = 0; ch < numChannels; ch++) {
+                block[i * numChannels + ch] = os->fade[i * numChannels + ch]
+                                            + gain * (block[i * numChannels + ch] - os->fade[i * numChannels + ch]);
+            }
+        }
+        os->fadeDone = os->fadeDone + numFrames < OVERSAMPLE_FADE_FRAMES ? os->fadeDone + numFrames : OVERSAMPLE_FADE_FRAMES;
+    }
+
+    for (ch = 0; ch < numChannels; ch++) {
+        memmove(os->input[ch], os->input[ch] + numFrames, OVERSAMPLE_PRIME_FRAMES * sizeof(float));
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name: besselI0()
+// Desc: Modified Bessel Function of the First Kind, Order 0, by its Series
+//-----------------------------------------------------------------------------
+static double besselI0(double x)
+{
+    double sum = 1, term = 1;
+    int    k;
+
+    for (k = 1; term > 1e-12 * sum; k++)
+    {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum  += term;
+    }
+    return sum;
+}
+
+//-----------------------------------------------------------------------------
+// Name: initialize_oversampler()
+// Desc: Kaiser-Windowed Halfband Designs. Every Other Tap of a Halfband is
+//       Zero Bar the Centre, so Each Stage Keeps Only the Nonzero Phase,
+//       Scaled by 2 so That Phase Alone Has Unity Gain at DC.
+//-----------------------------------------------------------------------------
+void initialize_oversampler(oversampler *os)
+{
+    int    k, p, q, taps;
+    double offset, x, sum;
+    float *coeffs;
+
+    memset(os, 0, sizeof(*os));
+    os->fadeDone = OVERSAMPLE_FADE_FRAMES;
+
+    /* Starts Dry, 1x Waits Out the Whole Round Trip */
+    for (p = 0; p < 2; p++)
+    {
+        os->paths[p].factor = 1;
+        os->paths[p].pad    = OVERSAMPLE_LATENCY;
+        os->paths[p].stages[0].taps = HALFBAND_TAPS_2X;
+        os->paths[p].stages[1].taps = HALFBAND_TAPS_4X;
+    }
+
+    for (k = 0; k < 2; k++)
+    {
+        taps   = os->paths[0].stages[k].taps;
+        coeffs = os->paths[0].stages[k].coeffs;
+        for (q = 0, sum = 0; q < taps; q++)
+        {
+            offset = 2 * q - (taps - 1);        // Odd Distance From the Centre Tap
+            x      = offset / taps;
+            coeffs[q] = (float)(sin(PI * offset / 2.0) / (PI * offset / 2.0)
+                              * besselI0(HALFBAND_KAISER_BETA * sqrt(1.0 - x * x)) / besselI0(HALFBAND_KAISER_BETA));
+            sum += coeffs[q];
+        }
+        for (q = 0; q < taps; q++) {
+            coeffs[q] /= sum;
+        }
+        memcpy(os->paths[1].stages[k].coeffs, coeffs, sizeof(os->paths[1].stages[k].coeffs));
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name: halfbandUp() / halfbandDown()
+// Desc: One Channel of Interleaved Audio Through One Stage. Upsampling, Even
+//       Outputs are the FIR Phase and Odd Ones the Input Delayed by Half the
+//       Filter. Downsampling Mirrors it: FIR Over the Even Inputs Plus the
+//       Delayed Odd Ones, Halved. Both Keep Their Tails for the Next Block.
+//-----------------------------------------------------------------------------
+static void halfbandUp(halfbandStage *s, int ch, const float *in, int numFrames, float *out, int numChannels, float *fir)
+{
+    float *history = s->up[ch];
+    int    i;
+
+    for (i = 0; i < numFrames; i++) {
+        history[s->taps - 1 + i] = in[i * numChannels + ch];
+    }
+    firSIMD(history, s->coeffs, s->taps, fir, numFrames);
+    for (i = 0; i < numFrames; i++)
+    {
+        out[(2 * i) * numChannels + ch]     = fir[i];
+        out[(2 * i + 1) * numChannels + ch] = history[i + s->taps / 2];
+    }
+    memmove(history, history + numFrames, (s->taps - 1) * sizeof(float));
+}
+
+static void halfbandDown(halfbandStage *s, int ch, const float *in, int numFrames, float *out, int numChannels, float *fir)
+{
+    float *even = s->even[ch], *odd = s->odd[ch];
+    int    i;
+
+    for (i = 0; i < numFrames; i++)
+    {
+        even[s->taps - 1 + i] = in[(2 * i) * numChannels + ch];
+        odd[s->taps / 2 + i]  = in[(2 * i + 1) * numChannels + ch];
+    }
+    firSIMD(even, s->coeffs, s->taps, fir, numFrames);
+    for (i = 0; i < numFrames; i++) {
+        out[i * numChannels + ch] = 0.5f * (fir[i] + odd[i]);
+    }
+    memmove(even, even + numFrames, (s->taps - 1) * sizeof(float));
+    memmove(odd, odd + numFrames, (s->taps / 2) * sizeof(float));
+}
+
+//-----------------------------------------------------------------------------
+// Name: firSIMD()
+// Desc: out[i] = Sum of coeffs[q] * in[i + q], Eight Outputs at a Time in Two
+//       Accumulators, One Coefficient Broadcast per Tap. Symmetric Filters
+//       Only, as the Taps Run Forward Over the History.
+//-----------------------------------------------------------------------------
+void firSIMD(const float *in, const float *coeffs, int taps, float *out, int numOutputs)
+{
+    int   i = 0, q;
+    float acc;
+
+#if defined(__SSE__)
+    for (; i + 8 <= numOutputs; i += 8)
+    {
+        __m128 a = _mm_setzero_ps(), b = _mm_setzero_ps();
+        for (q = 0; q < taps; q++)
+        {
+            __m128 c = _mm_set1_ps(coeffs[q]);
+            a = _mm_add_ps(a, _mm_mul_ps(c, _mm_loadu_ps(in + i + q)));
+            b = _mm_add_ps(b, _mm_mul_ps(c, _mm_loadu_ps(in + i + q + 4)));
+        }
+        _mm_storeu_ps(out + i, a);
+        _mm_storeu_ps(out + i + 4, b);
+    }
+#elif defined(__ARM_NEON)
+    for (; i + 8 <= numOutputs; i += 8)
+    {
+        float32x4_t a = vdupq_n_f32(0), b = vdupq_n_f32(0);
+        for (q = 0; q < taps; q++)
+        {
+            a = vmlaq_n_f32(a, vld1q_f32(in + i + q), coeffs[q]);
+            b = vmlaq_n_f32(b, vld1q_f32(in + i + q + 4), coeffs[q]);
+        }
+        vst1q_f32(out + i, a);
+        vst1q_f32(out + i + 4, b);
+    }
+#endif
+
+    /* Remainder, or Everything Without SIMD */
+    for (; i < numOutputs; i++)
+    {
+        for (q = 0, acc = 0; q < taps; q++) {
+            acc += coeffs[q] * in[i + q];
+        }
+        out[i] = acc;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name: keyboardFunc( )
+// Desc: key event
+//-----------------------------------------------------------------------------
+void keyboardFunc( unsigned char key, int x, int y )
+{
+
+    switch( key )
+    {
+        /* Fullscreen */
+        case 'f':
+            if( !g_fullscreen )
+            {
+                g_last_width = g_width;
+                g_last_height = g_height;
+                glutFullScreen();
+            }
+            else
+                glutReshapeWindow( g_last_width, g_last_height );
 
-    switch( key )
-    {
-        /* Fullscreen */
-        case 'f':
-            if( !g_fullscreen )
-            {
-                g_last_width = g_width;
-                g_last_height = g_height;
-                glutFullScreen();
-            }
-            else
-                glutReshapeWindow( g_last_width, g_last_height );
-
             g_fullscreen = !g_fullscreen;
             printGUI();
             break;
 
         /* Resets Normal Default Playback */
+        /* Controls Go Through Automation, the Panel Refreshes Once They Apply */
         case 'r':
-            data.src_data.src_ratio = 1;     //Sets Default Playback Speed
-            initialize_Filters();
-            data.amplitude = INITIAL_VOLUME;
-            printGUI();
+            postControl(AUTO_RATIO, 1);      //Sets Default Playback Speed, Selected Deck
+            postControl(AUTO_DIRECTION, 1);
+            postControl(AUTO_MOTOR, PLATTER_MOTOR_ON);
+            postControl(AUTO_LPF_ON, false);
+            postControl(AUTO_LPF_FREQ, 20000);
+            postControl(AUTO_LPF_RES, 1);
+            postControl(AUTO_HPF_ON, false);
+            postControl(AUTO_HPF_FREQ, 20);
+            postControl(AUTO_HPF_RES, 1);
+            postControl(AUTO_VOLUME, INITIAL_VOLUME);
             break;
 
         /* Change SRC Ratio */
         case '-':
-        	if (data.src_data.src_ratio <= 2.0)
+        	if (g_deck->src_ratio <= 2.0)
         	{
-            data.src_data.src_ratio += SRC_RATIO_INCREMENT;
+            nudgeControl(AUTO_RATIO, SRC_RATIO_INCREMENT);
             }
-            printGUI();
             break;
         case '=':
-        	if (data.src_data.src_ratio >= 0.5 )
+        	if (g_deck->src_ratio >= 0.5 )
         	{
-            data.src_data.src_ratio -= SRC_RATIO_INCREMENT;
+            nudgeControl(AUTO_RATIO, -SRC_RATIO_INCREMENT);
             }
-            printGUI();
+            break;
+
+        /* Reverse the Motor */
+        case 'b':
+            postControl(AUTO_DIRECTION, -g_deck->direction);
+            break;
+
+        /* Start/Stop Spins Up or Brakes, Power Lets the Platter Coast */
+        case ' ':
+            postControl(AUTO_MOTOR, g_deck->motor == PLATTER_MOTOR_ON ? PLATTER_MOTOR_BRAKE : PLATTER_MOTOR_ON);
+            break;
+        case 'n':
+            postControl(AUTO_MOTOR, g_deck->motor == PLATTER_MOTOR_ON ? PLATTER_MOTOR_OFF : PLATTER_MOTOR_ON);
             break;
 
         /* Low Pass Filter Controls */
         /****************************/
         /* Engage/Disengage Filter  */
         case 'l':
-            if (data.lpf_On == false)
-            {
-                //Power On
-                data.lpf_On = true;
-            }
-            else if (data.lpf_On == true)
-            {
-                //Power Off
-                data.lpf_On = false;
-            }
-            printGUI();
+            postControl(AUTO_LPF_ON, !g_deck->lpf_On);
             break;
 
         /* Increase/Decrease Lpf Freq Cutoff */
         case 'j':
-            data.lpf_freq -= FILTER_CUTOFF_INCREMENT;
-                if (data.lpf_freq < 20)
-                {
-                    data.lpf_freq = 20;
-                }
-                printGUI();
-                break;
+            nudgeControl(AUTO_LPF_FREQ, -FILTER_CUTOFF_INCREMENT);
+            break;
         case 'k':
-            data.lpf_freq += FILTER_CUTOFF_INCREMENT;
-                if (data.lpf_freq > 20000)
-                {
-                    data.lpf_freq = 20000;
-                }
-                printGUI();
-                break;
+            nudgeControl(AUTO_LPF_FREQ, FILTER_CUTOFF_INCREMENT);
+            break;
 
         /* Increase/Decrease Lpf Resonance  */
         case 'i':
-            data.lpf_res  -= RESONANCE_INCREMENT;
-                if (data.lpf_res <= 1)
-                {
-                    data.lpf_res = 1;
-                }
-                printGUI();
-                break;
+            nudgeControl(AUTO_LPF_RES, -RESONANCE_INCREMENT);
+            break;
         case 'o':
-            data.lpf_res  += RESONANCE_INCREMENT;
-                if (data.lpf_res >= 10)
-                {
-                    data.lpf_res = 10;
-                }
-                printGUI();
-                break;
+            nudgeControl(AUTO_LPF_RES, RESONANCE_INCREMENT);
+            break;
 
         /* High Pass Filter Controls */
         /*****************************/
         /* Engage/Disengage Filter   */
         case 'a':
-            if (data.hpf_On == false)
-            {
-                //Power On
-                data.hpf_On = true;
-            }
-            else if (data.hpf_On == true)
-            {
-                //Power Off
-                data.hpf_On = false;
-            }
-            printGUI();
-            break;                
+            postControl(AUTO_HPF_ON, !g_deck->hpf_On);
+            break;
 
         /* Increase/Decrease Hpf Freq Cutoff */
         case 's':
-            data.hpf_freq -= FILTER_CUTOFF_INCREMENT;
-                if (data.hpf_freq < 20)
-                {
-                    data.hpf_freq = 20;
-                }
-                printGUI();
-                break;
+            nudgeControl(AUTO_HPF_FREQ, -FILTER_CUTOFF_INCREMENT);
+            break;
         case 'd':
-            data.hpf_freq += FILTER_CUTOFF_INCREMENT;
-                if (data.hpf_freq > 20000)
-                {
-                    data.hpf_freq = 20000;
-                }
-                printGUI();
-                break;
+            nudgeControl(AUTO_HPF_FREQ, FILTER_CUTOFF_INCREMENT);
+            break;
 
-        /* Increase/Decrease Lpf Resonance  */
+        /* Increase/Decrease Hpf Resonance  */
         case 'w':
-            data.hpf_res  -= RESONANCE_INCREMENT;
-                if (data.hpf_res <= 1)
-                {
-                    data.hpf_res = 1;
-                }
-                printGUI();
-                break;
+            nudgeControl(AUTO_HPF_RES, -RESONANCE_INCREMENT);
+            break;
         case 'e':
-            data.hpf_res  += RESONANCE_INCREMENT;
-                if (data.hpf_res >= 10)
-                {
-                    data.hpf_res = 10;
-                }
-                printGUI();
-                break;
+            nudgeControl(AUTO_HPF_RES, RESONANCE_INCREMENT);
+            break;
 
         /* Amplitude Controls */
         /*****************************/
         /* Mute Output   */
         case 'm':
-            if (data.amplitude > 0 )
-            {
-                //Mute
-                data.amplitude = 0;
-            }
-            else if (data.amplitude == 0)
-            {
-                //UnMute
-                data.amplitude = INITIAL_VOLUME;
-            }
+            postControl(AUTO_VOLUME, g_deck->amplitude > 0 ? 0 : INITIAL_VOLUME);
             break;
 
-        /* Increase/Decrease Amplitude of Playbacl */
+        /* Increase/Decrease Amplitude of Playback */
         case ',': 
-            data.amplitude -= VOLUME_INCREMENT; 
-            if (data.amplitude < 0) {
-                data.amplitude = 0;
-            }
+            nudgeControl(AUTO_VOLUME, -VOLUME_INCREMENT);
             break;
         case '.': 
-            data.amplitude += VOLUME_INCREMENT;
-            if (data.amplitude > 1) {
-                data.amplitude = 1;
-            } 
+            nudgeControl(AUTO_VOLUME, VOLUME_INCREMENT);
+            break;
+
+        /* Two Decks: Which One the Keys and Mouse Work, and the Crossfader */
+        case '\t':
+            if (deckB.inFile != NULL)
+            {
+                g_deck = g_deck == &data ? &deckB : &data;
+                printGUI();
+            }
+            break;
+        case 'z':
+            nudgeControl(AUTO_CROSSFADER, -CROSSFADER_INCREMENT);
+            break;
+        case 'x':
+            nudgeControl(AUTO_CROSSFADER, CROSSFADER_INCREMENT);
+            break;
+        case 'c':
+            postControl(AUTO_CROSSFADER, CROSSFADER_CENTER);
+            break;
+
+        /* Persistence Trails */
+        case 'g':
+            g_trail.enabled = !g_trail.enabled && g_trail.available;
+            g_trail.filled  = 0;
+            g_trail.head    = 0;
+            break;
+
+        /* Whole-Track Overview Strip */
+        case 'p':
+            g_overview.visible = !g_overview.visible;
+            break;
+
+        /* Cycle What the Two Rings Show */
+        case 'v':
+            g_ring_mode = (g_ring_mode + 1) % (deckB.inFile != NULL ? RING_MODE_COUNT : RING_MODE_DECKS);
+            printGUI();
+            break;
+
+        /* Seeking, Picked Up by the Audio Thread at its Next Block */
+        case '[':
+            seekBy(-SEEK_SMALL_SECONDS);
+            break;
+        case ']':
+            seekBy(SEEK_SMALL_SECONDS);
+            break;
+        case '{':
+            seekBy(-SEEK_LARGE_SECONDS);
+            break;
+        case '}':
+            seekBy(SEEK_LARGE_SECONDS);
+            break;
+        case '0':
+            seekTo(0);
             break;
 
         /* Exit */
@@ -878,8 +3151,23 @@ void keyboardFunc( unsigned char key, int x, int y )
             /* Close Stream Before Exiting */
             stop_portAudio();
 
+            /* Finish the Automation Recording */
+            stop_automation(&data.automation);
+
+            /* Stop the Disk Readers and Deck B's Worker */
+            stop_frameCache(&data.cache);
+            if (deckB.inFile != NULL)
+            {
+                stop_deckWorker(&g_deck_worker);
+                stop_frameCache(&deckB.cache);
+            }
+
+            /* Write Out Whatever the Audio Thread Logged Last */
+            stop_eventLog();
+
             /* Cleanup SRC */
-            src_delete (data.src_state);
+            stop_governor(&data.governor);
+            stop_governor(&deckB.governor);
 
             /* End Curses Mode */
             endwin();
@@ -919,24 +3207,63 @@ void initialize_glut(int argc, char *argv[]) {
     glutSpecialFunc( specialKey );
     // set window's to specialUpKey callback (when the key is up is called)
     glutSpecialUpFunc( specialUpKey );
+    // mouse drags scratch the record
+    glutMouseFunc( mouseFunc );
+    glutMotionFunc( motionFunc );
     // do our own initialization
     initialize_graphics( );  
 }
 
 //-----------------------------------------------------------------------------
 // Name: idleFunc( )
-// Desc: callback from GLUT
+// Desc: callback from GLUT, Sleeps Until the Next Frame Deadline and Only
+//       Asks for a Redraw When There is Something New to Show
 //-----------------------------------------------------------------------------
 void idleFunc( )
 {
-    // render the scene
-    glutPostRedisplay( );
-}
+    double now = getTimeSeconds();
+    bool   fresh;
+
+    /* Without VSync Pacing the Swap, Sleep Off the Rest of the Frame */
+    if (!g_frame.vsync && now < g_frame.nextDeadline)
+    {
+        SLEEP( (g_frame.nextDeadline - now) * 1000.0 );
+        return;
+    }
+
+    /* Applied Control Changes Out to the Recording */
+    drainAutomation(&data.automation);
+
+    /* A Hand That Stopped Moving Holds the Record Still */
+    if (g_scratch_down && g_scratch_speed != 0 && now - g_scratch_time > SCRATCH_HOLD_SECONDS)
+    {
+        g_scratch_speed = 0;
+        postControl(AUTO_SCRATCH_SPEED, 0);
+    }
+
+    /* Nothing Changed Since the Last Frame, Check Back Shortly */
+    fresh = atomic_load_explicit(&g_audio_sequence, memory_order_acquire) != g_frame.lastSequence;
+    if (!fresh && !g_key_rotate_x && !g_key_rotate_y)
+    {
+        g_frame.framesSkipped++;
+        SLEEP( 1 );
+        return;
+    }
+
+    /* Stay on the Deadline Grid Unless We Fell a Whole Frame Behind */
+    g_frame.nextDeadline += g_frame.targetPeriod;
+    if (g_frame.nextDeadline < now) {
+        g_frame.nextDeadline = now + g_frame.targetPeriod;
+    }
+
+    // render the scene
+    glutPostRedisplay( );
+}
 
 //-----------------------------------------------------------------------------
-// Name: specialUpKey( int key, int x, int y)
-// Desc: Callback to know when a special key is pressed
-//-----------------------------------------------------------------------------
+// Name: specialUpKey( int key, int x, int y)
+// Desc: Callback to know when a special key is pressed
+//-----------------------------------------------------------------------------
 void specialKey(int key, int x, int y) { 
     // Check which (arrow) key is pressed
     switch(key) {
@@ -981,26 +3308,71 @@ void specialUpKey( int key, int x, int y) {
     }
 }
 
+//-----------------------------------------------------------------------------
+// Name: mouseFunc( int button, int state, int x, int y )
+// Desc: Left Button Puts a Hand on the Record, Releasing Hands it Back to the Motor
+//-----------------------------------------------------------------------------
+void mouseFunc( int button, int state, int x, int y )
+{
+    if (button != GLUT_LEFT_BUTTON) {
+        return;
+    }
+
+    if (state == GLUT_DOWN)
+    {
+        g_scratch_x     = x;
+        g_scratch_time  = getTimeSeconds();
+        g_scratch_speed = 0;
+        g_scratch_down  = true;
+        postControl(AUTO_SCRATCH_SPEED, 0);
+        postControl(AUTO_SCRATCH, true);
+    }
+    else
+    {
+        g_scratch_down = false;
+        postControl(AUTO_SCRATCH, false);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name: motionFunc( int x, int y )
+// Desc: Drag Velocity to Platter Speed, One Window Width is One Revolution
+//-----------------------------------------------------------------------------
+void motionFunc( int x, int y )
+{
+    double now = getTimeSeconds(), dt = now - g_scratch_time, speed;
+
+    if (!g_scratch_down || dt <= 0) {
+        return;
+    }
+
+    /* Turns per Second Over Normal Turns per Second */
+    speed = (double)(x - g_scratch_x) / g_width / dt * SCRATCH_TURN_SECONDS;
+    g_scratch_speed = g_scratch_speed * (1.0 - SCRATCH_SMOOTHING) + speed * SCRATCH_SMOOTHING;
+    postControl(AUTO_SCRATCH_SPEED, g_scratch_speed);
+
+    g_scratch_x    = x;
+    g_scratch_time = now;
+}
+
 //-----------------------------------------------------------------------------
 // Name: void rotateView ()
 // Desc: Rotates the current view by the angle specified in the globals
 //-----------------------------------------------------------------------------
 void rotateView () 
 {
-  static GLfloat angle_x = 0;
-  static GLfloat angle_y = 0;
   if (g_key_rotate_y) {
-    glRotatef ( angle_y += g_inc_y, 0.0f, 1.0f, 0.0f );
+    glRotatef ( g_angle_y += g_inc_y, 0.0f, 1.0f, 0.0f );
   }
   else {
-    glRotatef (angle_y, 0.0f, 1.0f, 0.0f );
+    glRotatef (g_angle_y, 0.0f, 1.0f, 0.0f );
   }
   
   if (g_key_rotate_x) {
-    glRotatef ( angle_x += g_inc_x, 1.0f, 0.0f, 0.0f );
+    glRotatef ( g_angle_x += g_inc_x, 1.0f, 0.0f, 0.0f );
   }
   else {
-    glRotatef (angle_x, 1.0f, 0.0f, 0.0f );
+    glRotatef (g_angle_x, 1.0f, 0.0f, 0.0f );
   }
 }
 
@@ -1036,6 +3408,8 @@ void reshapeFunc( int w, int h )
 //-----------------------------------------------------------------------------
 void initialize_graphics()
 {
+    int i;
+
     glClearColor(0.0f, 0.0f, 0.0f, 0.0f);                 // Black Background
     // set the shading model to 'smooth'
     glShadeModel( GL_SMOOTH );
@@ -1066,6 +3440,21 @@ void initialize_graphics()
     glLightfv( GL_LIGHT1, GL_DIFFUSE, g_light1_diffuse );
     glLightfv( GL_LIGHT1, GL_SPECULAR, g_light1_specular );
     glEnable( GL_LIGHT1 );
+
+    // persistent vertex buffers for the rings, respecified every frame
+    glGenBuffers( 2, g_ring_vbo );
+    for (i = 0; i < 2; i++)
+    {
+        glBindBuffer( GL_ARRAY_BUFFER, g_ring_vbo[i] );
+        glBufferData( GL_ARRAY_BUFFER, sizeof(g_ring_vertices[i]), NULL, GL_STREAM_DRAW );
+    }
+    glBindBuffer( GL_ARRAY_BUFFER, 0 );
+
+    // frame pacing and timing
+    initialize_frameScheduler( );
+
+    // history rings for the groove trails
+    initialize_trail( );
 }
 
 //-----------------------------------------------------------------------------
@@ -1075,156 +3464,5380 @@ void initialize_graphics()
 void displayFunc( )
 {
     /* Local Vairables */
-    float visualBuffer[g_buffer_size];
-    float visualBuffer2[g_buffer_size];
+    float left[g_buffer_size], right[g_buffer_size];
+    float outer[g_buffer_size], inner[g_buffer_size];
+    float envelope[g_buffer_size];
+    GLfloat rms, scale;
+    double  start, swapStart, end;
+    int     numVertices, innerRing;
+
+    start = getTimeSeconds();
 
-    /* Wait for Data */
-    while( !g_ready ) usleep( 1000 );
+    /* Note Which Audio Block This Frame Shows */
+    g_frame.lastSequence = atomic_load_explicit(&g_audio_sequence, memory_order_acquire);
 
-    /* Copy Currently Playing Audio Into Buffer */
-    memcpy( visualBuffer, data.src_outBuffer, g_buffer_size * sizeof(float) );
-    memcpy( visualBuffer2, data.src_outBuffer, g_buffer_size * sizeof(float) );
+    /* Latest Frames of Each Channel, or Each Deck, Shaped for the Current Ring Mode */
+    if (g_ring_mode == RING_MODE_DECKS) {
+        readDeckRings( left, right, g_buffer_size );
+    }
+    else {
+        channelHistoryRead( &g_deck->history, left, right, g_buffer_size );
+    }
+    splitRingChannels( g_ring_mode, left, right, g_buffer_size, outer, inner );
+
+    /* Time the GPU Work of This Frame, Read Back the Previous One */
+#if defined(GPU_TIMER_TARGET)
+    if (g_frame.gpuTimer)
+    {
+        glBeginQuery( GPU_TIMER_TARGET, g_frame.queries[g_frame.queryIndex] );
+    }
+#endif
 
-    /* Hand Off to Audio Callback Thread */
-    g_ready = false;
+    /* Refresh Meter Readout Whenever the Audio Thread Finished a Hop */
+    printMeters();
 
     // clear the color and depth buffers
     glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
 
-    /* Draw the Signal On The Screen */
-    drawCircle(3, g_buffer_size, visualBuffer, false);  //Outer Circle
-    drawCircle(3, g_buffer_size, visualBuffer, true);   //Inner Circle
+    /* Get the Actual Volume, Already Tracked by the Audio Thread */
+    rms = atomic_load_explicit(&data.envelope.rmsMix, memory_order_relaxed);
+
+    /* Get the Value to Scale the Inner Circle Based on the RMS Volume */
+    scale = (rms * 2 + 0.3)/1.5;
+
+    /* No More Vertices Than the Ring Covers Pixels */
+    numVertices = ringLODVertices(g_buffer_size, g_height);
+
+    /* Mixed Rings Match, so That Mode Builds One and Draws it Twice */
+    updateRingGeometry(0, RING_RADIUS, numVertices, ringLOD(outer, g_buffer_size, numVertices, envelope));
+    innerRing = 0;
+    if (g_ring_mode != RING_MODE_MIX)
+    {
+        updateRingGeometry(1, RING_RADIUS, numVertices, ringLOD(inner, g_buffer_size, numVertices, envelope));
+        innerRing = 1;
+    }
+    drawCircle(0, numVertices, 1.0f);           //Outer Circle
+    drawCircle(innerRing, numVertices, scale);  //Inner Circle
+
+    /* Fading History Behind the Live Ring */
+    if (g_trail.enabled)
+    {
+        appendTrailBlock(numVertices);
+        drawTrail();
+    }
+
+    /* Whole Track Along the Bottom */
+    drawOverview();
+
+#if defined(GPU_TIMER_TARGET)
+    if (g_frame.gpuTimer)
+    {
+        gpuTimerValue gpuNs = 0;
+        GLint available = 0;
+
+        glEndQuery( GPU_TIMER_TARGET );
+        g_frame.queryIndex ^= 1;
+        glGetQueryObjectiv( g_frame.queries[g_frame.queryIndex], GL_QUERY_RESULT_AVAILABLE, &available );
+        if (available)
+        {
+            GPU_TIMER_RESULT( g_frame.queries[g_frame.queryIndex], GL_QUERY_RESULT, &gpuNs );
+            g_frame.gpuTime += 0.1 * (gpuNs * 1e-9 - g_frame.gpuTime);
+        }
+    }
+#endif
 
     // flush gl commands
     glFlush( );
 
     // swap the buffers
+    swapStart = getTimeSeconds();
     glutSwapBuffers( );
+    end = getTimeSeconds();
+
+    /* Swap Blocking for a Good Part of the Frame Means the Driver Waits on VSync */
+    g_frame.cpuTime  += 0.1 * ((swapStart - start) - g_frame.cpuTime);
+    g_frame.swapTime += 0.1 * ((end - swapStart) - g_frame.swapTime);
+    if (g_frame.lastSwapEnd > 0) {
+        g_frame.frameInterval += 0.1 * ((end - g_frame.lastSwapEnd) - g_frame.frameInterval);
+    }
+    g_frame.lastSwapEnd = end;
+    g_frame.vsync = g_frame.swapTime > VSYNC_SWAP_FRACTION * g_frame.frameInterval &&
+                    g_frame.frameInterval >= 0.95 * g_frame.targetPeriod;
+    g_frame.framesDrawn++;
+
+    printFrameStats();
+    printOverviewStatus();
+    printCacheStatus();
+    printEventLog();
+    printAutomationStatus();
+}
+
+//-----------------------------------------------------------------------------
+// Name: initialize_frameScheduler( )
+// Desc: Sets the FPS Cap and Looks for a GPU Timer Query Extension
+//-----------------------------------------------------------------------------
+void initialize_frameScheduler()
+{
+    const char* extensions = (const char*)glGetString( GL_EXTENSIONS );
+
+    memset(&g_frame, 0, sizeof(g_frame));
+    g_frame.targetPeriod    = 1.0 / g_options.max_fps;
+    g_frame.frameInterval   = g_frame.targetPeriod;
+    g_frame.nextDeadline    = getTimeSeconds();
+    g_frame.windowStart     = g_frame.nextDeadline;
+    g_frame.windowThreadCpu = getThreadCpuSeconds();
+
+#if defined(GPU_TIMER_TARGET)
+    if (extensions != NULL && (strstr(extensions, "GL_ARB_timer_query") != NULL ||
+                               strstr(extensions, "GL_EXT_timer_query") != NULL))
+    {
+        glGenQueries( 2, g_frame.queries );
+        g_frame.gpuTimer = true;
+    }
+#else
+    (void)extensions;
+#endif
+}
+
+//-----------------------------------------------------------------------------
+// Name: printFrameStats( )
+// Desc: Render Rate, Per-Frame CPU/GPU Time and How Busy the GLUT Thread Is
+//-----------------------------------------------------------------------------
+void printFrameStats()
+{
+    double now = getTimeSeconds(), threadCpu, busy;
+    char   gpu[16];
+
+    if (now - g_frame.windowStart < FRAME_STATS_INTERVAL) {
+        return;
+    }
+
+    /* Share of Wall Time the Render Thread Spent on a CPU */
+    threadCpu = getThreadCpuSeconds();
+    busy = 100.0 * (threadCpu - g_frame.windowThreadCpu) / (now - g_frame.windowStart);
+
+    if (g_frame.gpuTimer) {
+        snprintf(gpu, sizeof(gpu), "%.2f ms", g_frame.gpuTime * 1000.0);
+    }
+    else {
+        snprintf(gpu, sizeof(gpu), "n/a");
+    }
+
+    mvprintw(22,0,"Render: %5.1f fps  CPU %.2f ms  GPU %s  Thread Busy %5.1f%%  Idle Polls %d  VSync %s\n",
+        g_frame.framesDrawn / (now - g_frame.windowStart), g_frame.cpuTime * 1000.0, gpu,
+        busy, g_frame.framesSkipped, g_frame.vsync ? "On" : "Off");
+    refresh();
+
+    g_frame.framesDrawn     = 0;
+    g_frame.framesSkipped   = 0;
+    g_frame.windowStart     = now;
+    g_frame.windowThreadCpu = threadCpu;
+}
+
+//-----------------------------------------------------------------------------
+// Name: void updateRingTable(ringTable *table, int num_segments)
+// Desc: Caches cos/sin of Every Segment Angle, Exact Rather Than Recurrence
+//-----------------------------------------------------------------------------
+void updateRingTable(ringTable *table, int num_segments) 
+{
+    int i;
+
+    if (num_segments > RING_MAX_SEGMENTS) {
+        num_segments = RING_MAX_SEGMENTS;
+    }
+    if (table->segments == num_segments) {
+        return;
+    }
+
+    for (i = 0; i < num_segments; i++)
+    {
+        table->cosTable[i] = (float)cos(2.0 * PI * i / num_segments);
+        table->sinTable[i] = (float)sin(2.0 * PI * i / num_segments);
+    }
+    table->segments = num_segments;
+}
+
+//-----------------------------------------------------------------------------
+// Name: int ringLODVertices(int numSamples, int viewportHeight)
+// Desc: Vertices Worth Drawing for the Ring at This Viewport Height. The Outer
+//       Extent of the Ring Projects to 2*pi*(R + depth)*focal/distance Pixels;
+//       Once the Window Holds More Than Two Samples per Pixel it is Reduced to
+//       One min/max Pair per Pixel, Otherwise Every Sample Gets a Vertex.
+//-----------------------------------------------------------------------------
+int ringLODVertices(int numSamples, int viewportHeight)
+{
+    float focal  = (viewportHeight * 0.5f) / tanf(CAMERA_FOVY * 0.5f * PI / 180.0f);
+    int   pixels = (int)ceilf(2.0f * PI * (RING_RADIUS + RING_DEPTH) * focal / CAMERA_DISTANCE);
+    int   numVertices = numSamples;
+
+    if (pixels < 1) {
+        pixels = 1;
+    }
+    if (numSamples > 2 * pixels) {
+        numVertices = 2 * pixels;
+    }
+    if (numVertices > RING_MAX_SEGMENTS) {
+        numVertices = RING_MAX_SEGMENTS & ~1;
+    }
+    return numVertices;
+}
+
+//-----------------------------------------------------------------------------
+// Name: decimateMinMax()
+// Desc: Splits samples Into numPairs Equal Bins and Writes Each Bin's Minimum
+//       Then Maximum to envelope, so Drawn in Order the Pairs Trace the Full
+//       Swing of Every Pixel Instead of Whichever Sample Lands on it
+//-----------------------------------------------------------------------------
+void decimateMinMax(const float *samples, int numSamples, int numPairs, float *envelope)
+{
+    int b, i, begin, end;
+    float lo, hi;
+
+    for (b = 0; b < numPairs; b++)
+    {
+        begin = (int)((long)b * numSamples / numPairs);
+        end   = (int)((long)(b + 1) * numSamples / numPairs);
+        i  = begin;
+        lo = hi = samples[begin];
+
+#if defined(__SSE__)
+        if (end - begin >= 4)
+        {
+            __m128 vLo = _mm_loadu_ps(samples + begin);
+            __m128 vHi = vLo;
+            __m128 x;
+
+            for (i = begin + 4; i + 4 <= end; i += 4)
+            {
+                x   = _mm_loadu_ps(samples + i);
+                vLo = _mm_min_ps(vLo, x);
+                vHi = _mm_max_ps(vHi, x);
+            }
+
+            /* Horizontal Reduction of the Four Lanes */
+            vLo = _mm_min_ps(vLo, _mm_movehl_ps(vLo, vLo));
+            vLo = _mm_min_ss(vLo, _mm_shuffle_ps(vLo, vLo, _MM_SHUFFLE(1, 1, 1, 1)));
+            vHi = _mm_max_ps(vHi, _mm_movehl_ps(vHi, vHi));
+            vHi = _mm_max_ss(vHi, _mm_shuffle_ps(vHi, vHi, _MM_SHUFFLE(1, 1, 1, 1)));
+            lo  = _mm_cvtss_f32(vLo);
+            hi  = _mm_cvtss_f32(vHi);
+        }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+        if (end - begin >= 4)
+        {
+            float32x4_t vLo = vld1q_f32(samples + begin);
+            float32x4_t vHi = vLo;
+            float32x4_t x;
+
+            for (i = begin + 4; i + 4 <= end; i += 4)
+            {
+                x   = vld1q_f32(samples + i);
+                vLo = vminq_f32(vLo, x);
+                vHi = vmaxq_f32(vHi, x);
+            }
+            lo = vminvq_f32(vLo);
+            hi = vmaxvq_f32(vHi);
+        }
+#endif
+
+        /* Remainder, or Everything Without SIMD */
+        for (; i < end; i++)
+        {
+            lo = fminf(lo, samples[i]);
+            hi = fmaxf(hi, samples[i]);
+        }
+
+        envelope[2*b]     = lo;
+        envelope[2*b + 1] = hi;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name: ringLOD()
+// Desc: Returns the Values to Build numVertices Ring Vertices From, Either the
+//       Samples Themselves or Their min/max Pairs Written to envelope
+//-----------------------------------------------------------------------------
+const float* ringLOD(const float *samples, int numSamples, int numVertices, float *envelope)
+{
+    if (numVertices >= numSamples) {
+        return samples;
+    }
+    decimateMinMax(samples, numSamples, numVertices / 2, envelope);
+    return envelope;
+}
+
+//-----------------------------------------------------------------------------
+// Name: splitRingChannels()
+// Desc: Shapes the Two Channels Into What the Outer and Inner Rings Show
+//-----------------------------------------------------------------------------
+void splitRingChannels(int mode, const float *left, const float *right, int numFrames,
+                       float *outer, float *inner)
+{
+    int i;
+
+    switch (mode)
+    {
+        case RING_MODE_DECKS:                   // Already One Deck per Channel, From readDeckRings()
+        case RING_MODE_LR:
+            memcpy(outer, left,  numFrames * sizeof(float));
+            memcpy(inner, right, numFrames * sizeof(float));
+            break;
+        case RING_MODE_MS:
+            for (i = 0; i < numFrames; i++)
+            {
+                outer[i] = 0.5f * (left[i] + right[i]);
+                inner[i] = 0.5f * (left[i] - right[i]);
+            }
+            break;
+        default:
+            for (i = 0; i < numFrames; i++) {
+                outer[i] = inner[i] = 0.5f * (left[i] + right[i]);
+            }
+            break;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name: generateRingGeometry()
+// Desc: Pure Vertex Generation, No GL State. Vertex i Sits at
+//       table[i] * (radius + samples[i] * depth) With z = samples[i], Colored
+//       (1, -s, s, s). positions Receives xyz Triples, colors rgba Quads.
+//-----------------------------------------------------------------------------
+void generateRingGeometry(const ringTable *table, const float *samples, int num_segments,
+                          float radius, float depth, float *positions, float *colors) 
+{
+    int i = 0;
+
+    if (num_segments > table->segments) {
+        num_segments = table->segments;
+    }
+
+#if defined(__SSE__)
+    {
+        const __m128 vRadius   = _mm_set1_ps(radius);
+        const __m128 vDepth    = _mm_set1_ps(depth);
+        const __m128 colorSign = _mm_set_ps(1.0f, 1.0f, -1.0f, 0.0f);
+        const __m128 colorBase = _mm_set_ps(0.0f, 0.0f,  0.0f, 1.0f);
+        __m128 s, r, X, Y, lo, hi, t;
+
+        for (; i + 4 <= num_segments; i += 4)
+        {
+            /* Four Vertices per Iteration */
+            s = _mm_loadu_ps(samples + i);
+            r = _mm_add_ps(vRadius, _mm_mul_ps(s, vDepth));
+            X = _mm_mul_ps(_mm_loadu_ps(table->cosTable + i), r);
+            Y = _mm_mul_ps(_mm_loadu_ps(table->sinTable + i), r);
+
+            /* Transpose x x x x / y y y y / z z z z Into xyz xyz xyz xyz */
+            lo = _mm_unpacklo_ps(X, Y);                                 // x0 y0 x1 y1
+            hi = _mm_unpackhi_ps(X, Y);                                 // x2 y2 x3 y3
+            t  = _mm_shuffle_ps(s, lo, _MM_SHUFFLE(2, 2, 0, 0));        // z0 z0 x1 x1
+            _mm_storeu_ps(positions + 3*i,     _mm_shuffle_ps(lo, t, _MM_SHUFFLE(2, 0, 1, 0)));
+            t  = _mm_shuffle_ps(lo, s, _MM_SHUFFLE(1, 1, 3, 3));        // y1 y1 z1 z1
+            _mm_storeu_ps(positions + 3*i + 4, _mm_shuffle_ps(t, hi, _MM_SHUFFLE(1, 0, 2, 0)));
+            t  = _mm_shuffle_ps(s, hi, _MM_SHUFFLE(3, 2, 3, 2));        // z2 z3 x3 y3
+            _mm_storeu_ps(positions + 3*i + 8, _mm_shuffle_ps(t, t, _MM_SHUFFLE(1, 3, 2, 0)));
+
+            /* One Register per Color */
+            _mm_storeu_ps(colors + 4*i,      _mm_add_ps(colorBase, _mm_mul_ps(colorSign, _mm_set1_ps(samples[i]))));
+            _mm_storeu_ps(colors + 4*i + 4,  _mm_add_ps(colorBase, _mm_mul_ps(colorSign, _mm_set1_ps(samples[i + 1]))));
+            _mm_storeu_ps(colors + 4*i + 8,  _mm_add_ps(colorBase, _mm_mul_ps(colorSign, _mm_set1_ps(samples[i + 2]))));
+            _mm_storeu_ps(colors + 4*i + 12, _mm_add_ps(colorBase, _mm_mul_ps(colorSign, _mm_set1_ps(samples[i + 3]))));
+        }
+    }
+#endif
+
+    /* Remainder, or Everything Without SIMD */
+    for (; i < num_segments; i++)
+    {
+        float r = radius + samples[i] * depth;
+
+        positions[3*i]     = table->cosTable[i] * r;
+        positions[3*i + 1] = table->sinTable[i] * r;
+        positions[3*i + 2] = samples[i];
+
+        colors[4*i]     = 1;
+        colors[4*i + 1] = -samples[i];
+        colors[4*i + 2] = samples[i];
+        colors[4*i + 3] = samples[i];
+    }
 }
 
 //-----------------------------------------------------------------------------
-// Name: void drawTimeDomain(float r, float num_segments, float* buffer)
-// Desc: Draws a Circle based on Radius r, length, and sample buffer
-// Circle Skeleton From - http://slabode.exofire.net/circle_draw.shtml
+// Name: void updateRingGeometry(int ring, float r, int num_segments, const float* buffer)
+// Desc: Builds the Ring of Radius r for the Sample Buffer and Streams it Into
+//       g_ring_vbo[ring] With a Single Upload. Positions Come First, Then Colors.
 //-----------------------------------------------------------------------------
-void drawCircle(float r, int num_segments, float* buffer, bool scalar) 
+void updateRingGeometry(int ring, float r, int num_segments, const float* buffer) 
 { 
-    float theta = 2 * PI / (float)num_segments; 
-    float tangetial_factor = tanf(theta);           //calculate the tangential factor 
-    float radial_factor = cosf(theta);              //calculate the radial factor 
-    
-    float x = r;//we start at angle = 0 
-    float y = 0; 
-    int   i;
+    if (num_segments > RING_MAX_SEGMENTS) {
+        num_segments = RING_MAX_SEGMENTS;
+    }
+
+    updateRingTable(&g_ring_table, num_segments);
+    generateRingGeometry(&g_ring_table, buffer, num_segments, r, RING_DEPTH,
+                         g_ring_vertices[ring], g_ring_vertices[ring] + num_segments * 3);
 
-    // Get the actual volume
-    GLfloat rms = computeRMS(buffer);
+    /* Orphan Last Frame's Storage so the Driver Never Stalls, Then Upload */
+    glBindBuffer( GL_ARRAY_BUFFER, g_ring_vbo[ring] );
+    glBufferData( GL_ARRAY_BUFFER, sizeof(g_ring_vertices[ring]), NULL, GL_STREAM_DRAW );
+    glBufferSubData( GL_ARRAY_BUFFER, 0, num_segments * 7 * sizeof(GLfloat), g_ring_vertices[ring] );
+    glBindBuffer( GL_ARRAY_BUFFER, 0 );
+}
 
-    // Get the value to scale the speaker based on the rms volume
-    GLfloat scale = (rms * 2 + 0.3)/1.5; 
+//-----------------------------------------------------------------------------
+// Name: void drawCircle(int ring, int num_segments, GLfloat scale)
+// Desc: Draws the Ring Currently in g_ring_vbo[ring], Scaled by scale
+//-----------------------------------------------------------------------------
+void drawCircle(int ring, int num_segments, GLfloat scale) 
+{ 
+    if (num_segments > RING_MAX_SEGMENTS) {
+        num_segments = RING_MAX_SEGMENTS;
+    }
 
     glPushMatrix(); 
     {
-        // //Translate
-        glTranslatef(0, 0, 0.0f);
-        
         //Rotate
         rotateView();
 
         /* Scale Size of Circle Based on Track Amplitude */
-        if (scalar == true)
-        {
-            glScalef(scale, scale, scale);  
-        }
-
-        glBegin(GL_LINE_LOOP); 
-            for (i = 0; i < num_segments; i++) 
-            { 
-                /* Change Color Based on Track Amplitude */
-                glColor4f(1, -buffer[i], buffer[i], buffer[i]);
-                
-                /* Animate Circle Z-Depth Based on Track Amplitude */
-                glVertex3f(x + 0, y + 0, buffer[i]); 
-                                
-                glRotatef(buffer[i], buffer[i], buffer[i], buffer[i]);
-               
-                /* Calculate the Tangential Vector 
-                   Remember, the Radial Vector is (x, y), 
-                   to Get the Tangential Vector we Flip Those Coordinates and Negate One of Them */
-                float tx = -y; 
-                float ty = x; 
-                
-                /* Add the Tangential Vector */ 
-                x += tx * tangetial_factor; 
-                y += ty * tangetial_factor; 
-                
-                /* Correct Using the Radial Factor */ 
-                x *= radial_factor; 
-                y *= radial_factor; 
-            } 
-        glEnd(); 
+        glScalef(scale, scale, scale);  
+
+        glBindBuffer( GL_ARRAY_BUFFER, g_ring_vbo[ring] );
+        glEnableClientState( GL_VERTEX_ARRAY );
+        glEnableClientState( GL_COLOR_ARRAY );
+        glVertexPointer( 3, GL_FLOAT, 0, (const GLvoid*)0 );
+        glColorPointer( 4, GL_FLOAT, 0, (const GLvoid*)(num_segments * 3 * sizeof(GLfloat)) );
+
+        glDrawArrays( GL_LINE_LOOP, 0, num_segments );
+
+        glDisableClientState( GL_COLOR_ARRAY );
+        glDisableClientState( GL_VERTEX_ARRAY );
+        glBindBuffer( GL_ARRAY_BUFFER, 0 );
     }
     glPopMatrix();
 }
 
 //-----------------------------------------------------------------------------
-// Name: float computeRMS(SAMPLE *buffer)
-// Desc: Computes an RMS Value for use in Scaling Circle
+// Name: trailVertexShader / trailFragmentShader
+// Desc: Age Comes From the Stamp Baked Into Each Block, so Old Blocks Fade and
+//       Spread Outward Without the CPU Ever Touching Them Again
 //-----------------------------------------------------------------------------
-float computeRMS(float *buffer) 
+static const char* trailVertexShader =
+    "#version 120\n"
+    "uniform float u_frame;\n"
+    "uniform float u_rings;\n"
+    "uniform float u_spread;\n"
+    "uniform float u_opacity;\n"
+    "attribute float a_stamp;\n"
+    "void main() {\n"
+    "    float age  = mod(u_frame - a_stamp + 65536.0, 65536.0);\n"
+    "    float fade = 1.0 - age / u_rings;\n"
+    "    vec4  v    = vec4(gl_Vertex.xy * (1.0 + age * u_spread), gl_Vertex.z, 1.0);\n"
+    "    gl_Position   = gl_ModelViewProjectionMatrix * v;\n"
+    "    gl_FrontColor = vec4(gl_Color.rgb, fade * u_opacity);\n"
+    "}\n";
+
+static const char* trailFragmentShader =
+    "#version 120\n"
+    "void main() {\n"
+    "    gl_FragColor = gl_Color;\n"
+    "}\n";
+
+//-----------------------------------------------------------------------------
+// Name: initialize_trail( )
+// Desc: Builds the Trail Shader, the Buffer Itself is Sized on First Append
+//-----------------------------------------------------------------------------
+void initialize_trail()
 {
-    float rms = 0;
-    int i;
-    for (i = 0; i < g_buffer_size; i++) {
-        rms += buffer[i] * buffer[i];
+    GLuint vs, fs;
+    GLint  ok = 0;
+
+    memset(&g_trail, 0, sizeof(g_trail));
+    g_trail.rings = g_options.trail_rings;
+
+    vs = glCreateShader( GL_VERTEX_SHADER );
+    glShaderSource( vs, 1, &trailVertexShader, NULL );
+    glCompileShader( vs );
+    fs = glCreateShader( GL_FRAGMENT_SHADER );
+    glShaderSource( fs, 1, &trailFragmentShader, NULL );
+    glCompileShader( fs );
+
+    g_trail.program = glCreateProgram( );
+    glAttachShader( g_trail.program, vs );
+    glAttachShader( g_trail.program, fs );
+    glLinkProgram( g_trail.program );
+    glDeleteShader( vs );
+    glDeleteShader( fs );
+
+    glGetProgramiv( g_trail.program, GL_LINK_STATUS, &ok );
+    if (!ok)
+    {
+        printf("Warning, GLSL 1.20 Unavailable, Groove Trails Disabled\n");
+        glDeleteProgram( g_trail.program );
+        return;
     }
-    return sqrtf(rms / g_buffer_size);
+
+    g_trail.u_frame   = glGetUniformLocation( g_trail.program, "u_frame" );
+    g_trail.u_rings   = glGetUniformLocation( g_trail.program, "u_rings" );
+    g_trail.u_spread  = glGetUniformLocation( g_trail.program, "u_spread" );
+    g_trail.u_opacity = glGetUniformLocation( g_trail.program, "u_opacity" );
+    g_trail.a_stamp   = glGetAttribLocation( g_trail.program, "a_stamp" );
+
+    glGenBuffers( 1, &g_trail.vbo );
+    g_trail.available = true;
 }
 
 //-----------------------------------------------------------------------------
-// Name: float computeRMS(SAMPLE *buffer)
-// Desc: Computes an RMS Value for use in Scaling Circle
+// Name: appendTrailBlock(int num_segments)
+// Desc: Copies This Frame's Ring Into the Oldest Block, Stamped With the
+//       Frame Number. Constant Cost no Matter How Long the Trail Is.
 //-----------------------------------------------------------------------------
-void brickwall(float *buffer, int numChannels) 
+void appendTrailBlock(int num_segments)
 {
-    int   i;
-    float sample;
+    const GLfloat *position = g_ring_vertices[0];
+    const GLfloat *color    = g_ring_vertices[0] + num_segments * 3;
+    GLfloat *v = g_trail.block;
+    GLfloat  stamp;
+    int i;
+
+    if (num_segments > RING_MAX_SEGMENTS) {
+        num_segments = RING_MAX_SEGMENTS;
+    }
 
-    /* Clip Sample if it Goes out of Bit Depth */
-    for (i = 0; i < FRAMES_PER_BUFFER * numChannels; i++)
+    /* Block Size Follows the Segment Count, Start Over When it Changes */
+    glBindBuffer( GL_ARRAY_BUFFER, g_trail.vbo );
+    if (num_segments != g_trail.segments)
     {
-        sample = buffer[i];
-        if (sample > 32767) 
-        {
-            sample = 32767;
-        }
-        else if (sample < -32767) 
+        g_trail.segments = num_segments;
+        g_trail.head     = 0;
+        g_trail.filled   = 0;
+        glBufferData( GL_ARRAY_BUFFER,
+                      g_trail.rings * num_segments * TRAIL_VERTEX_FLOATS * sizeof(GLfloat),
+                      NULL, GL_DYNAMIC_DRAW );
+        for (i = 0; i < g_trail.rings; i++)
         {
-            sample = -32767;
+            g_trail.firsts[i] = i * num_segments;
+            g_trail.counts[i] = num_segments;
         }
-        buffer[i] = sample;
     }
+
+    /* Interleave xyz, rgba and the Stamp */
+    stamp = (GLfloat)(g_trail.frame % TRAIL_STAMP_WRAP);
+    for (i = 0; i < num_segments; i++, v += TRAIL_VERTEX_FLOATS)
+    {
+        v[0] = position[3*i];
+        v[1] = position[3*i + 1];
+        v[2] = position[3*i + 2];
+        v[3] = color[4*i];
+        v[4] = color[4*i + 1];
+        v[5] = color[4*i + 2];
+        v[6] = color[4*i + 3];
+        v[7] = stamp;
+    }
+
+    glBufferSubData( GL_ARRAY_BUFFER,
+                     g_trail.head * num_segments * TRAIL_VERTEX_FLOATS * sizeof(GLfloat),
+                     num_segments * TRAIL_VERTEX_FLOATS * sizeof(GLfloat), g_trail.block );
+    glBindBuffer( GL_ARRAY_BUFFER, 0 );
+
+    g_trail.head = (g_trail.head + 1) % g_trail.rings;
+    if (g_trail.filled < g_trail.rings) {
+        g_trail.filled++;
+    }
+    g_trail.frame++;
 }
 
 //-----------------------------------------------------------------------------
-// Name: void printGUI() 
-// Desc: Print Updateable GUI
+// Name: drawTrail( )
+// Desc: Every History Block in One Draw Call, Additively Blended
 //-----------------------------------------------------------------------------
-void printGUI() 
+void drawTrail()
 {
-    /* Speed Ratio */
-    mvprintw(14,0,"Speed Ratio: %.2f\n", data.src_data.src_ratio);
+    const GLsizei stride = TRAIL_VERTEX_FLOATS * sizeof(GLfloat);
 
-    /* Low Pass Filter */
-    mvprintw(15,0,"LPF: %s\n", data.filterState[(int)data.lpf_On]);
-    mvprintw(16,0,"Frequency: %dhz\n", data.lpf_freq);
-    mvprintw(17,0,"Resonance: %d\n", data.lpf_res);
+    if (g_trail.filled == 0) {
+        return;
+    }
 
-    /* High Pass Filter */
-    mvprintw(15,20,"HPF: %s\n", data.filterState[(int)data.hpf_On]);
-    mvprintw(16,20,"Frequency: %dhz\n", data.hpf_freq);
-    mvprintw(17,20,"Resonance: %d\n", data.hpf_res);
+    glPushMatrix();
+    glRotatef( g_angle_y, 0.0f, 1.0f, 0.0f );
+    glRotatef( g_angle_x, 1.0f, 0.0f, 0.0f );
+
+    glUseProgram( g_trail.program );
+    glUniform1f( g_trail.u_frame,   (GLfloat)((g_trail.frame - 1) % TRAIL_STAMP_WRAP) );
+    glUniform1f( g_trail.u_rings,   (GLfloat)g_trail.rings );
+    glUniform1f( g_trail.u_spread,  TRAIL_SPREAD );
+    glUniform1f( g_trail.u_opacity, TRAIL_OPACITY );
+
+    glBindBuffer( GL_ARRAY_BUFFER, g_trail.vbo );
+    glEnableClientState( GL_VERTEX_ARRAY );
+    glEnableClientState( GL_COLOR_ARRAY );
+    glEnableVertexAttribArray( g_trail.a_stamp );
+    glVertexPointer( 3, GL_FLOAT, stride, (const GLvoid*)0 );
+    glColorPointer( 4, GL_FLOAT, stride, (const GLvoid*)(3 * sizeof(GLfloat)) );
+    glVertexAttribPointer( g_trail.a_stamp, 1, GL_FLOAT, GL_FALSE, stride, (const GLvoid*)(7 * sizeof(GLfloat)) );
+
+    /* Fades Add Up Instead of Occluding Each Other */
+    glEnable( GL_BLEND );
+    glBlendFunc( GL_SRC_ALPHA, GL_ONE );
+    glDepthMask( GL_FALSE );
+
+    glMultiDrawArrays( GL_LINE_LOOP, g_trail.firsts, g_trail.counts, g_trail.filled );
+
+    glDepthMask( GL_TRUE );
+    glDisable( GL_BLEND );
+    glDisableVertexAttribArray( g_trail.a_stamp );
+    glDisableClientState( GL_COLOR_ARRAY );
+    glDisableClientState( GL_VERTEX_ARRAY );
+    glBindBuffer( GL_ARRAY_BUFFER, 0 );
+    glUseProgram( 0 );
 
-    mvprintw(18,0,"\n");
-    refresh();
-}
\ No newline at end of file
+    glPopMatrix();
+}
+
+//-----------------------------------------------------------------------------
+// Name: initialize_envelopeFollower()
+// Desc: Clears the Running Sums and Envelopes
+//-----------------------------------------------------------------------------
+void initialize_envelopeFollower(envelopeFollower *env, int sampleRate, int numChannels)
+{
+    int ch;
+
+    memset(env, 0, sizeof(*env));
+    env->numChannels = numChannels;
+    env->sampleRate  = sampleRate;
+    for (ch = 0; ch < STEREO; ch++)
+    {
+        atomic_store(&env->rms[ch], 0.0f);
+        atomic_store(&env->peak[ch], 0.0f);
+    }
+    atomic_store(&env->rmsMix, 0.0f);
+}
+
+//-----------------------------------------------------------------------------
+// Name: envelopeFollowerProcess()
+// Desc: Slides the RMS Window Over an Interleaved Block Sample by Sample,
+//       Then Smooths Window RMS and Block Peak With Attack/Release at Block Rate
+//-----------------------------------------------------------------------------
+void envelopeFollowerProcess(envelopeFollower *env, const float *buffer, int numFrames)
+{
+    int    i, ch, w = env->writeIndex;
+    int    numChannels = env->numChannels;
+    float  x, sq, rms, peak[STEREO] = { 0, 0 }, coeff, mix = 0;
+    double sum[STEREO];
+    float  attack  = expf(-numFrames / (ENVELOPE_ATTACK_MS  * 0.001f * env->sampleRate));
+    float  release = expf(-numFrames / (ENVELOPE_RELEASE_MS * 0.001f * env->sampleRate));
+
+    for (ch = 0; ch < numChannels; ch++) {
+        sum[ch] = env->sumSquares[ch];
+    }
+
+    /* Running Sums, Oldest Square Leaves as the Newest Enters */
+    for (i = 0; i < numFrames; i++)
+    {
+        for (ch = 0; ch < numChannels; ch++)
+        {
+            x  = buffer[i * numChannels + ch];
+            sq = x * x;
+            sum[ch] += sq - env->squares[w][ch];
+            env->squares[w][ch] = sq;
+            if (fabsf(x) > peak[ch]) {
+                peak[ch] = fabsf(x);
+            }
+        }
+        if (++w == ENVELOPE_WINDOW) {
+            w = 0;
+        }
+    }
+    env->writeIndex = w;
+
+    for (ch = 0; ch < numChannels; ch++)
+    {
+        /* Rounding Can Leave the Sum a Hair Below Zero on Silence */
+        if (sum[ch] < 0) {
+            sum[ch] = 0;
+        }
+        env->sumSquares[ch] = sum[ch];
+        rms = sqrtf((float)(sum[ch] / ENVELOPE_WINDOW));
+
+        coeff = rms > env->rmsEnv[ch] ? attack : release;
+        env->rmsEnv[ch] = rms + coeff * (env->rmsEnv[ch] - rms);
+
+        coeff = peak[ch] > env->peakEnv[ch] ? attack : release;
+        env->peakEnv[ch] = peak[ch] + coeff * (env->peakEnv[ch] - peak[ch]);
+
+        atomic_store_explicit(&env->rms[ch],  env->rmsEnv[ch],  memory_order_relaxed);
+        atomic_store_explicit(&env->peak[ch], env->peakEnv[ch], memory_order_relaxed);
+        mix += env->rmsEnv[ch];
+    }
+    atomic_store_explicit(&env->rmsMix, mix / numChannels, memory_order_relaxed);
+}
+
+//-----------------------------------------------------------------------------
+// Name: float computeRMS(SAMPLE *buffer)
+// Desc: Computes an RMS Value for use in Scaling Circle
+//-----------------------------------------------------------------------------
+float computeRMS(float *buffer) 
+{
+    float rms = 0;
+    int i;
+    for (i = 0; i < g_buffer_size; i++) {
+        rms += buffer[i] * buffer[i];
+    }
+    return sqrtf(rms / g_buffer_size);
+}
+
+//-----------------------------------------------------------------------------
+// Name: initialize_limiter()
+// Desc: Sets Lookahead, Ceiling and Release, Clears the Delay Line
+//-----------------------------------------------------------------------------
+void initialize_limiter(peakLimiter *lim, int sampleRate, int numChannels, float lookahead_ms)
+{
+    int i;
+
+    memset(lim, 0, sizeof(*lim));
+    lim->numChannels  = numChannels;
+    lim->ceiling      = powf(10.0f, LIMITER_CEILING_DB / 20.0f);
+    lim->releaseCoeff = expf(-1.0f / (LIMITER_RELEASE_MS * 0.001f * sampleRate));
+    lim->held         = 1.0f;
+
+    /* Window Covers lookahead + 1 Frames, and the Deque Holds One Expired
+       Frame More Until brickwall() Pops It, so lookahead + 2 Must Fit the Rings */
+    lim->lookahead = (int)(lookahead_ms * 0.001f * sampleRate + 0.5f);
+    if (lim->lookahead < 1) {
+        lim->lookahead = 1;
+    }
+    if (lim->lookahead > LIMITER_MAX_LOOKAHEAD - 2) {
+        lim->lookahead = LIMITER_MAX_LOOKAHEAD - 2;
+    }
+
+    /* Unity Gain History */
+    for (i = 0; i < LIMITER_MAX_LOOKAHEAD; i++) {
+        lim->gainRing[i] = 1.0f;
+    }
+    lim->gainSum = lim->lookahead + 1;
+    atomic_store(&lim->gainReduction, 0.0f);
+}
+
+//-----------------------------------------------------------------------------
+// Name: void brickwall(peakLimiter *lim, float *buffer, int numFrames)
+// Desc: Lookahead Peak Limiter, Output is Delayed by lim->lookahead Frames.
+//       Gain for Frame n is the Moving Average Over [n-L, n] of the Release
+//       Smoothed ceiling/peak, Where peak is the Sliding Max Over the Same
+//       Window. Every Term is Already Below the Gain Frame n-L Needs, so the
+//       Delayed Output Never Exceeds the Ceiling and the Attack is a Ramp.
+//-----------------------------------------------------------------------------
+void brickwall(peakLimiter *lim, float *buffer, int numFrames) 
+{
+    const unsigned int mask = LIMITER_MAX_LOOKAHEAD - 1;
+    const unsigned int L    = lim->lookahead;
+    const int   numChannels = lim->numChannels;
+    const float rc          = lim->releaseCoeff;
+    const float norm        = 1.0f / (L + 1);
+    int   i, ch, n, run;
+    unsigned int f, slot;
+    float peak, target, *frame, *delayed, tmp;
+    float deepest = 1.0f;
+
+    for (n = 0; n < numFrames; n += run)
+    {
+        run = numFrames - n;
+        if (run > LIMITER_CHUNK) {
+            run = LIMITER_CHUNK;
+        }
+
+        /* Gain Computer, Serial by Nature */
+        for (i = 0; i < run; i++)
+        {
+            f     = lim->frame++;
+            slot  = f & mask;
+            frame = buffer + (n + i) * numChannels;
+
+            /* Frame Peak Across Channels */
+            peak = fabsf(frame[0]);
+            for (ch = 1; ch < numChannels; ch++) {
+                if (fabsf(frame[ch]) > peak) {
+                    peak = fabsf(frame[ch]);
+                }
+            }
+
+            /* Monotonic Deque: Drop Smaller Peaks From the Back, Expired From the Front */
+            lim->peaks[slot] = peak;
+            while (lim->dequeTail != lim->dequeHead &&
+                   lim->peaks[lim->deque[(lim->dequeTail - 1) & mask] & mask] <= peak) {
+                lim->dequeTail--;
+            }
+            lim->deque[lim->dequeTail++ & mask] = f;
+            while (f - lim->deque[lim->dequeHead & mask] > L) {
+                lim->dequeHead++;
+            }
+            peak = lim->peaks[lim->deque[lim->dequeHead & mask] & mask];
+
+            /* Instant Attack to the Required Gain, Exponential Release Above It */
+            target = peak > lim->ceiling ? lim->ceiling / peak : 1.0f;
+            if (target < lim->held) {
+                lim->held = target;
+            }
+            else {
+                lim->held = target + rc * (lim->held - target);
+            }
+
+            /* Running Sum Over the Window, Rebuilt Once per Ring Lap Against Drift */
+            lim->gainSum += lim->held - lim->gainRing[(f - L - 1) & mask];
+            lim->gainRing[slot] = lim->held;
+            if (slot == 0) {
+                lim->gainSum = 0;
+                for (ch = 0; ch <= (int)L; ch++) {
+                    lim->gainSum += lim->gainRing[(f - ch) & mask];
+                }
+            }
+            lim->gains[i] = (float)lim->gainSum * norm;
+            if (lim->gains[i] > 1.0f) {
+                lim->gains[i] = 1.0f;
+            }
+            if (lim->gains[i] < deepest) {
+                deepest = lim->gains[i];
+            }
+
+            /* Swap Current Frame Into the Delay Line, Delayed Frame Out */
+            delayed = lim->delay + ((f - L) & mask) * numChannels;
+            for (ch = 0; ch < numChannels; ch++)
+            {
+                tmp = frame[ch];
+                frame[ch] = delayed[ch];
+                lim->delay[slot * numChannels + ch] = tmp;
+            }
+        }
+
+        /* Gain Application, Vectorized */
+        applyGainSIMD(buffer + n * numChannels, lim->gains, run, numChannels);
+    }
+
+    atomic_store_explicit(&lim->gainReduction, 20.0f * log10f(deepest), memory_order_relaxed);
+}
+
+//-----------------------------------------------------------------------------
+// Name: applyGainSIMD()
+// Desc: buffer[frame][ch] *= gains[frame] for Interleaved Mono or Stereo
+//-----------------------------------------------------------------------------
+void applyGainSIMD(float *buffer, const float *gains, int numFrames, int numChannels)
+{
+    int i = 0, ch;
+
+#if defined(__SSE__)
+    if (numChannels == STEREO)
+    {
+        /* Two Frames per Register: g0 g0 g1 g1 */
+        for (; i + 2 <= numFrames; i += 2)
+        {
+            __m128 g = _mm_loadl_pi(_mm_setzero_ps(), (const __m64*)(gains + i));
+            g = _mm_unpacklo_ps(g, g);
+            _mm_storeu_ps(buffer + 2 * i, _mm_mul_ps(_mm_loadu_ps(buffer + 2 * i), g));
+        }
+    }
+    else if (numChannels == MONO)
+    {
+        for (; i + 4 <= numFrames; i += 4) {
+            _mm_storeu_ps(buffer + i, _mm_mul_ps(_mm_loadu_ps(buffer + i), _mm_loadu_ps(gains + i)));
+        }
+    }
+#elif defined(__ARM_NEON)
+    if (numChannels == STEREO)
+    {
+        for (; i + 2 <= numFrames; i += 2)
+        {
+            float32x2x2_t z = vzip_f32(vld1_f32(gains + i), vld1_f32(gains + i));
+            float32x4_t g = vcombine_f32(z.val[0], z.val[1]);
+            vst1q_f32(buffer + 2 * i, vmulq_f32(vld1q_f32(buffer + 2 * i), g));
+        }
+    }
+    else if (numChannels == MONO)
+    {
+        for (; i + 4 <= numFrames; i += 4) {
+            vst1q_f32(buffer + i, vmulq_f32(vld1q_f32(buffer + i), vld1q_f32(gains + i)));
+        }
+    }
+#endif
+
+    /* Remainder, or Everything Without SIMD */
+    for (; i < numFrames; i++) {
+        for (ch = 0; ch < numChannels; ch++) {
+            buffer[i * numChannels + ch] *= gains[i];
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name: mixSIMD()
+// Desc: buffer = buffer * gains + other * otherGains, One Gain per Frame for
+//       Each Input, Shared Across its Channels
+//-----------------------------------------------------------------------------
+void mixSIMD(float *buffer, const float *other, const float *gains, const float *otherGains, int numFrames, int numChannels)
+{
+    int i = 0, ch;
+
+#if defined(__SSE__)
+    if (numChannels == STEREO)
+    {
+        /* Two Frames per Register: g0 g0 g1 g1 */
+        for (; i + 2 <= numFrames; i += 2)
+        {
+            __m128 g = _mm_loadl_pi(_mm_setzero_ps(), (const __m64*)(gains + i));
+            __m128 h = _mm_loadl_pi(_mm_setzero_ps(), (const __m64*)(otherGains + i));
+            g = _mm_unpacklo_ps(g, g);
+            h = _mm_unpacklo_ps(h, h);
+            _mm_storeu_ps(buffer + 2 * i, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(buffer + 2 * i), g),
+                                                     _mm_mul_ps(_mm_loadu_ps(other + 2 * i), h)));
+        }
+    }
+    else if (numChannels == MONO)
+    {
+        for (; i + 4 <= numFrames; i += 4)
+        {
+            _mm_storeu_ps(buffer + i, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(buffer + i), _mm_loadu_ps(gains + i)),
+                                                 _mm_mul_ps(_mm_loadu_ps(other + i), _mm_loadu_ps(otherGains + i))));
+        }
+    }
+#elif defined(__ARM_NEON)
+    if (numChannels == STEREO)
+    {
+        for (; i + 2 <= numFrames; i += 2)
+        {
+            float32x2x2_t z = vzip_f32(vld1_f32(gains + i), vld1_f32(gains + i));
+            float32x2x2_t w = vzip_f32(vld1_f32(otherGains + i), vld1_f32(otherGains + i));
+            float32x4_t g = vcombine_f32(z.val[0], z.val[1]);
+            float32x4_t h = vcombine_f32(w.val[0], w.val[1]);
+            vst1q_f32(buffer + 2 * i, vmlaq_f32(vmulq_f32(vld1q_f32(buffer + 2 * i), g), vld1q_f32(other + 2 * i), h));
+        }
+    }
+    else if (numChannels == MONO)
+    {
+        for (; i + 4 <= numFrames; i += 4) {
+            vst1q_f32(buffer + i, vmlaq_f32(vmulq_f32(vld1q_f32(buffer + i), vld1q_f32(gains + i)),
+                                            vld1q_f32(other + i), vld1q_f32(otherGains + i)));
+        }
+    }
+#endif
+
+    /* Remainder, or Everything Without SIMD */
+    for (; i < numFrames; i++) {
+        for (ch = 0; ch < numChannels; ch++) {
+            buffer[i * numChannels + ch] = buffer[i * numChannels + ch] * gains[i] +
+                                           other[i * numChannels + ch] * otherGains[i];
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name: deinterleaveSIMD()
+// Desc: Splits Interleaved Stereo Into Separate left and right Arrays
+//-----------------------------------------------------------------------------
+void deinterleaveSIMD(const float *buffer, float *left, float *right, int numFrames)
+{
+    int i = 0;
+
+#if defined(__SSE__)
+    /* Four Frames per Iteration: L0 R0 L1 R1 | L2 R2 L3 R3 */
+    for (; i + 4 <= numFrames; i += 4)
+    {
+        __m128 a = _mm_loadu_ps(buffer + 2 * i);
+        __m128 b = _mm_loadu_ps(buffer + 2 * i + 4);
+        _mm_storeu_ps(left  + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+        _mm_storeu_ps(right + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+#elif defined(__ARM_NEON)
+    for (; i + 4 <= numFrames; i += 4)
+    {
+        float32x4x2_t lr = vld2q_f32(buffer + 2 * i);
+        vst1q_f32(left  + i, lr.val[0]);
+        vst1q_f32(right + i, lr.val[1]);
+    }
+#endif
+
+    /* Remainder, or Everything Without SIMD */
+    for (; i < numFrames; i++)
+    {
+        left[i]  = buffer[2 * i];
+        right[i] = buffer[2 * i + 1];
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name: initialize_channelHistory()
+// Desc: Empties the Visual History for a Mono or Stereo Stream
+//-----------------------------------------------------------------------------
+void initialize_channelHistory(channelHistory *h, int numChannels)
+{
+    memset(h->ring, 0, sizeof(h->ring));
+    h->numChannels = numChannels;
+    atomic_store(&h->writePos, 0);
+}
+
+//-----------------------------------------------------------------------------
+// Name: channelHistoryWrite()
+// Desc: Appends One Interleaved Block, Deinterleaved, Then Publishes it. At Most
+//       Two Contiguous Spans, so the Audio Thread Does Two SIMD Passes at Worst.
+//-----------------------------------------------------------------------------
+void channelHistoryWrite(channelHistory *h, const float *buffer, int numFrames)
+{
+    unsigned int writePos = atomic_load_explicit(&h->writePos, memory_order_relaxed);
+    int pos  = writePos & (VISUAL_HISTORY - 1);
+    int span = numFrames < VISUAL_HISTORY - pos ? numFrames : VISUAL_HISTORY - pos;
+
+    if (h->numChannels == STEREO)
+    {
+        deinterleaveSIMD(buffer, h->ring[0] + pos, h->ring[1] + pos, span);
+        deinterleaveSIMD(buffer + 2 * span, h->ring[0], h->ring[1], numFrames - span);
+    }
+    else
+    {
+        memcpy(h->ring[0] + pos, buffer, span * sizeof(float));
+        memcpy(h->ring[0], buffer + span, (numFrames - span) * sizeof(float));
+    }
+
+    atomic_store_explicit(&h->writePos, writePos + numFrames, memory_order_release);
+}
+
+//-----------------------------------------------------------------------------
+// Name: channelHistoryRead()
+// Desc: Copies the Newest numFrames of Each Channel, Mono Fills Both. The Audio
+//       Thread Only Writes Ahead of writePos, so Reading Well Inside the History
+//       Never Races it.
+//-----------------------------------------------------------------------------
+void channelHistoryRead(channelHistory *h, float *left, float *right, int numFrames)
+{
+    unsigned int writePos = atomic_load_explicit(&h->writePos, memory_order_acquire);
+    int pos  = (writePos - numFrames) & (VISUAL_HISTORY - 1);
+    int span = numFrames < VISUAL_HISTORY - pos ? numFrames : VISUAL_HISTORY - pos;
+    int ch   = h->numChannels == STEREO ? 1 : 0;
+
+    memcpy(left, h->ring[0] + pos, span * sizeof(float));
+    memcpy(left + span, h->ring[0], (numFrames - span) * sizeof(float));
+    memcpy(right, h->ring[ch] + pos, span * sizeof(float));
+    memcpy(right + span, h->ring[ch], (numFrames - span) * sizeof(float));
+}
+
+//-----------------------------------------------------------------------------
+// Name: wrapFrame(sf_count_t position, sf_count_t frames)
+// Desc: File Frame Under a Stream Position. Streams Loop the File Forever, in
+//       Either Direction, so Positions Run Past Both Ends.
+//-----------------------------------------------------------------------------
+static sf_count_t wrapFrame(sf_count_t position, sf_count_t frames)
+{
+    position %= frames;
+    return position < 0 ? position + frames : position;
+}
+
+//-----------------------------------------------------------------------------
+// Name: cacheReadFile()
+// Desc: Reader Thread: numFrames Frames From Stream Position Into dst, Looping
+//       at the End of the File. Seeks Only When the Handle is Elsewhere.
+//-----------------------------------------------------------------------------
+static void cacheReadFile(frameCache *c, float *dst, sf_count_t position, sf_count_t numFrames)
+{
+    sf_count_t frame, run, got;
+
+    while (numFrames > 0)
+    {
+        frame = wrapFrame(position, c->fileFrames);
+        run   = numFrames < c->fileFrames - frame ? numFrames : c->fileFrames - frame;
+
+        if (c->fileCursor != frame && sf_seek(c->file, frame, SEEK_SET) < 0) {
+            got = 0;
+        }
+        else {
+            got = sf_readf_float(c->file, dst, run);
+        }
+        if (got < 0) {
+            got = 0;
+        }
+        if (got < run) {
+            memset(dst + got * c->numChannels, 0, (run - got) * c->numChannels * sizeof(float));
+        }
+        c->fileCursor = got == run ? frame + run : -1;
+
+        dst       += run * c->numChannels;
+        position  += run;
+        numFrames -= run;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name: cacheFill()
+// Desc: Reader Thread: Decodes Positions [position, position + numFrames) Into
+//       Their Slots of a Window, Splitting Where the Slots Wrap
+//-----------------------------------------------------------------------------
+static void cacheFill(frameCache *c, cacheWindow *w, sf_count_t position, sf_count_t numFrames)
+{
+    sf_count_t slot  = position & (CACHE_FRAMES - 1);
+    sf_count_t first = numFrames < CACHE_FRAMES - slot ? numFrames : CACHE_FRAMES - slot;
+
+    cacheReadFile(c, w->frames + slot * c->numChannels, position, first);
+    if (numFrames > first) {
+        cacheReadFile(c, w->frames, position + first, numFrames - first);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name: cacheExtendEnd() / cacheExtendStart()
+// Desc: Reader Thread: Grows a Window by One Disk Read at Either Side.
+//       Positions Whose Slots are About to be Reused Leave the Valid Range
+//       Before They are Written.
+//-----------------------------------------------------------------------------
+static void cacheExtendEnd(frameCache *c, cacheWindow *w, sf_count_t start, sf_count_t end, sf_count_t n)
+{
+    if (end + n - CACHE_FRAMES > start) {
+        atomic_store_explicit(&w->start, end + n - CACHE_FRAMES, memory_order_release);
+    }
+    cacheFill(c, w, end, n);
+    atomic_store_explicit(&w->end, end + n, memory_order_release);
+}
+
+static void cacheExtendStart(frameCache *c, cacheWindow *w, sf_count_t start, sf_count_t end, sf_count_t n)
+{
+    if (start - n + CACHE_FRAMES < end) {
+        atomic_store_explicit(&w->end, start - n + CACHE_FRAMES, memory_order_release);
+    }
+    cacheFill(c, w, start - n, n);
+    atomic_store_explicit(&w->start, start - n, memory_order_release);
+}
+
+//-----------------------------------------------------------------------------
+// Name: cacheTopUp()
+// Desc: Reader Thread: One Disk Read Toward CACHE_AHEAD Frames Past the Play
+//       Position in the Direction of Travel, Otherwise Toward CACHE_BEHIND
+//       the Other Way. Returns false When the Window Already Covers Both.
+//-----------------------------------------------------------------------------
+static bool cacheTopUp(frameCache *c, cacheWindow *w, sf_count_t play)
+{
+    sf_count_t start = atomic_load_explicit(&w->start, memory_order_relaxed);
+    sf_count_t end   = atomic_load_explicit(&w->end, memory_order_relaxed);
+    bool       reverse = atomic_load_explicit(&c->direction, memory_order_relaxed) < 0;
+    sf_count_t after   = play + (reverse ? CACHE_BEHIND : CACHE_AHEAD) - end;
+    sf_count_t before  = start - (play - (reverse ? CACHE_AHEAD : CACHE_BEHIND));
+
+    /* Playhead Left the Window Entirely, Start Over Where it Is */
+    if (play < start || play > end)
+    {
+        atomic_store_explicit(&w->start, play, memory_order_release);
+        atomic_store_explicit(&w->end, play, memory_order_release);
+        return cacheTopUp(c, w, play);
+    }
+
+    if (after > 0 && (!reverse || before <= 0))
+    {
+        cacheExtendEnd(c, w, start, end, after < CACHE_READ_FRAMES ? after : CACHE_READ_FRAMES);
+        return true;
+    }
+    if (before > 0)
+    {
+        cacheExtendStart(c, w, start, end, before < CACHE_READ_FRAMES ? before : CACHE_READ_FRAMES);
+        return true;
+    }
+    return false;
+}
+
+//-----------------------------------------------------------------------------
+// Name: cacheService()
+// Desc: Reader Side: Services a Seek, or Else Tops Up the Window Around the
+//       Playhead. A Seek Outside the Current Window is Prefetched Into the
+//       Other Window, Which the Audio Thread Only Switches to at its Next
+//       Read, so Neither Side Ever Waits on the Other. Returns false When
+//       There is Nothing to Do Until the Audio Side Moves.
+//-----------------------------------------------------------------------------
+static bool cacheService(frameCache *c)
+{
+    unsigned int requests;
+    sf_count_t   target, first;
+    cacheWindow *w;
+
+    /* Leave Both Windows Alone Until the Last Seek Was Taken */
+    if (atomic_load_explicit(&c->seekApplied, memory_order_acquire) != c->published) {
+        return false;
+    }
+
+    requests = atomic_load_explicit(&c->seekRequests, memory_order_acquire);
+    if (requests != c->handled)
+    {
+        c->handled = requests;
+        target = atomic_load_explicit(&c->seekTarget, memory_order_relaxed);
+
+        /* Far Jumps Prefetch Into the Idle Window First, on the Side Playback Heads */
+        first = atomic_load_explicit(&c->direction, memory_order_relaxed) < 0 ?
+                target - CACHE_PREFETCH_FRAMES : target;
+        w = &c->windows[c->current];
+        if (first < atomic_load(&w->start) || first + CACHE_PREFETCH_FRAMES > atomic_load(&w->end))
+        {
+            c->current ^= 1;
+            w = &c->windows[c->current];
+            atomic_store(&w->start, first);
+            atomic_store(&w->end, first);
+            cacheFill(c, w, first, CACHE_PREFETCH_FRAMES);
+            atomic_store_explicit(&w->end, first + CACHE_PREFETCH_FRAMES, memory_order_release);
+        }
+
+        atomic_store_explicit(&c->seekWindow, c->current, memory_order_relaxed);
+        atomic_store_explicit(&c->seekPosition, target, memory_order_relaxed);
+        atomic_store_explicit(&c->seekPublished, ++c->published, memory_order_release);
+        return true;
+    }
+
+    return cacheTopUp(c, &c->windows[c->current], atomic_load_explicit(&c->playPosition, memory_order_relaxed));
+}
+
+//-----------------------------------------------------------------------------
+// Name: cacheReaderMain()
+// Desc: Services the Cache Until Told to Quit, Napping When it Has Caught Up
+//-----------------------------------------------------------------------------
+static void* cacheReaderMain(void *arg)
+{
+    frameCache *c = (frameCache*)arg;
+    struct timespec nap = { 0, CACHE_POLL_US * 1000 };
+
+    while (!atomic_load_explicit(&c->quit, memory_order_relaxed))
+    {
+        if (!cacheService(c)) {
+            nanosleep(&nap, NULL);
+        }
+    }
+    return NULL;
+}
+
+//-----------------------------------------------------------------------------
+// Name: frameCacheService()
+// Desc: Without a Reader Thread (Export and Golden), the Caller Does its Work
+//       Between Blocks: Publishes a Pending Seek, or Fills the Window Out to
+//       CACHE_AHEAD. Every Run Then Reads the Same Frames at the Same Time.
+//-----------------------------------------------------------------------------
+void frameCacheService(frameCache *c)
+{
+    if (!c->synchronous) {
+        return;
+    }
+    while (cacheService(c)) {
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name: initialize_frameCache()
+// Desc: Opens a Second Handle on the File for the Reader, Fills the First
+//       Window Ahead of Frame 0 and Starts the Thread, Unless threaded is
+//       false and the Caller Runs frameCacheService() Itself
+//-----------------------------------------------------------------------------
+void initialize_frameCache(frameCache *c, const char* inFile, bool threaded)
+{
+    SF_INFO info;
+    int i;
+
+    memset(&info, 0, sizeof(info));
+    c->running = false;
+    if ((c->file = sf_open(inFile, SFM_READ, &info)) == NULL || info.frames <= 0) {
+        return;
+    }
+
+    c->numChannels = info.channels;
+    c->fileFrames  = info.frames;
+    c->fileCursor  = 0;
+    for (i = 0; i < 2; i++)
+    {
+        c->windows[i].frames = calloc((size_t)CACHE_FRAMES * info.channels, sizeof(float));
+        prefaultMemory(c->windows[i].frames, (size_t)CACHE_FRAMES * info.channels * sizeof(float));
+        atomic_store(&c->windows[i].start, 0);
+        atomic_store(&c->windows[i].end, 0);
+    }
+    atomic_store(&c->quit, false);
+    atomic_store(&c->seekRequests, 0);
+    atomic_store(&c->seekPublished, 0);
+    atomic_store(&c->seekApplied, 0);
+    atomic_store(&c->playPosition, 0);
+    atomic_store(&c->direction, 1);
+    atomic_store(&c->underruns, 0);
+    c->window    = 0;
+    c->position  = 0;
+    c->seekSeen  = 0;
+    c->handled   = 0;
+    c->published = 0;
+    c->current   = 0;
+
+    /* Playback Starts From Memory */
+    while (cacheTopUp(c, &c->windows[0], 0)) {
+    }
+
+    c->synchronous = !threaded;
+    if (c->synchronous)
+    {
+        c->running = true;
+        return;
+    }
+    c->running = pthread_create(&c->thread, NULL, cacheReaderMain, c) == 0;
+    if (c->running) {
+        pinThread(c->thread, RT_THREAD_READER);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name: stop_frameCache()
+// Desc: Joins the Reader Thread and Frees the Windows
+//-----------------------------------------------------------------------------
+void stop_frameCache(frameCache *c)
+{
+    if (c->running && !c->synchronous)
+    {
+        atomic_store(&c->quit, true);
+        pthread_join(c->thread, NULL);
+    }
+    c->running = false;
+    if (c->file != NULL) {
+        sf_close(c->file);
+    }
+    free(c->windows[0].frames);
+    free(c->windows[1].frames);
+    c->file = NULL;
+    c->windows[0].frames = c->windows[1].frames = NULL;
+}
+
+//-----------------------------------------------------------------------------
+// Name: frameCacheRead() / frameCachePeek() / frameCacheAdvance()
+// Desc: Audio Thread: Takes a Published Seek, Then Copies the Next numFrames
+//       Frames in the Direction of Travel Out of Memory, Last Frame First
+//       When Going Backwards. Frames the Reader Has Not Reached are Silence,
+//       Never a Wait. Returns true When a Seek Was Taken or the Direction
+//       Flipped so the Caller Can Reset the Resampler. The Playhead Only
+//       Moves by What the Resampler Consumed, Through frameCacheAdvance().
+//       frameCachePeek() Copies From Any Position Without Taking Seeks.
+//-----------------------------------------------------------------------------
+bool frameCacheRead(frameCache *c, float *dst, int numFrames, int direction)
+{
+    unsigned int seq = atomic_load_explicit(&c->seekPublished, memory_order_acquire);
+    bool seeked = false;
+
+    if (seq != c->seekSeen)
+    {
+        c->seekSeen = seq;
+        c->window   = atomic_load_explicit(&c->seekWindow, memory_order_relaxed);
+        c->position = atomic_load_explicit(&c->seekPosition, memory_order_relaxed);
+        atomic_store_explicit(&c->seekApplied, seq, memory_order_release);
+        seeked = true;
+    }
+    if (direction != atomic_load_explicit(&c->direction, memory_order_relaxed))
+    {
+        atomic_store_explicit(&c->direction, direction, memory_order_relaxed);
+        seeked = true;
+    }
+
+    frameCachePeek(c, dst, c->position, numFrames, direction);
+    return seeked;
+}
+
+void frameCachePeek(frameCache *c, float *dst, sf_count_t from, int numFrames, int direction)
+{
+    bool missing = false;
+    sf_count_t start, end, first, position, slot, run;
+    float *a, *b, t;
+    cacheWindow *w;
+    int i, k;
+
+    w     = &c->windows[c->window];
+    start = atomic_load_explicit(&w->start, memory_order_acquire);
+    end   = atomic_load_explicit(&w->end, memory_order_acquire);
+    first = direction < 0 ? from - numFrames : from;
+
+    for (i = 0; i < numFrames; i += run)
+    {
+        position = first + i;
+        slot = position & (CACHE_FRAMES - 1);
+        run  = numFrames - i < CACHE_FRAMES - slot ? numFrames - i : CACHE_FRAMES - slot;
+
+        if (position >= start && position + run <= end)
+        {
+            memcpy(dst + i * c->numChannels, w->frames + slot * c->numChannels,
+                   run * c->numChannels * sizeof(float));
+        }
+        else
+        {
+            memset(dst + i * c->numChannels, 0, run * c->numChannels * sizeof(float));
+            missing = true;
+        }
+    }
+    if (missing)
+    {
+        atomic_fetch_add_explicit(&c->underruns, 1, memory_order_relaxed);
+        postEvent(LOG_CACHE_UNDERRUN, numFrames, first);
+    }
+
+    /* Backwards, the Resampler Sees the Frames in Playing Order */
+    if (direction < 0)
+    {
+        for (i = 0; i < numFrames / 2; i++)
+        {
+            a = dst + i * c->numChannels;
+            b = dst + (numFrames - 1 - i) * c->numChannels;
+            for (k = 0; k < c->numChannels; k++) {
+                t = a[k]; a[k] = b[k]; b[k] = t;
+            }
+        }
+    }
+}
+
+void frameCacheAdvance(frameCache *c, int numFrames)
+{
+    c->position += numFrames;
+    atomic_store_explicit(&c->playPosition, c->position, memory_order_relaxed);
+}
+
+//-----------------------------------------------------------------------------
+// Name: seekTo(sf_count_t frame) / seekBy(double seconds)
+// Desc: Control API for the Selected Deck. Seeks Go Through Automation so
+//       They are Recorded With Everything Else.
+//-----------------------------------------------------------------------------
+void seekTo(sf_count_t frame)
+{
+    postControl(AUTO_SEEK, (double)frame);
+}
+
+void seekBy(double seconds)
+{
+    frameCache *c = &g_deck->cache;
+    sf_count_t play;
+
+    if (!c->running) {
+        return;
+    }
+    play = wrapFrame(atomic_load_explicit(&c->playPosition, memory_order_relaxed), c->fileFrames);
+    seekTo(play + (sf_count_t)(seconds * g_deck->sfinfo1.samplerate));
+}
+
+//-----------------------------------------------------------------------------
+// Name: requestSeek(paData *data, sf_count_t frame)
+// Desc: Audio Thread, From a Seek Change. Targets Land in the Same Lap of
+//       the Looping Stream so Jumps Inside the Cached Window Cost Nothing.
+//       Live, They Take Effect Once the Reader Publishes Them, Offline on the
+//       Next Read. Without a Cache at All the File Moves Right Away.
+//-----------------------------------------------------------------------------
+void requestSeek(paData *data, sf_count_t frame)
+{
+    frameCache *c = &data->cache;
+    sf_count_t play, frames = c->running ? c->fileFrames : data->sfinfo1.frames;
+
+    if (frame < 0) {
+        frame = 0;
+    }
+    if (frame >= frames) {
+        frame = frames - 1;
+    }
+
+    if (!c->running)
+    {
+        sf_seek(data->inFile, frame, SEEK_SET);
+        return;
+    }
+
+    play = atomic_load_explicit(&c->playPosition, memory_order_relaxed);
+    atomic_store_explicit(&c->seekTarget, play - wrapFrame(play, c->fileFrames) + frame, memory_order_relaxed);
+    atomic_fetch_add_explicit(&c->seekRequests, 1, memory_order_release);
+    frameCacheService(c);
+}
+
+//-----------------------------------------------------------------------------
+// Name: printCacheStatus()
+// Desc: Playhead Time, How Much is Decoded Around it and Blocks That Ran Dry
+//-----------------------------------------------------------------------------
+void printCacheStatus()
+{
+    static double lastPrint = 0;
+    frameCache *c = &data.cache;
+    double now = getTimeSeconds(), rate = data.sfinfo1.samplerate;
+    sf_count_t play, start, end, frame;
+    cacheWindow *w;
+
+    if (!c->running || now - lastPrint < FRAME_STATS_INTERVAL) {
+        return;
+    }
+    lastPrint = now;
+
+    play  = atomic_load_explicit(&c->playPosition, memory_order_relaxed);
+    w     = &c->windows[atomic_load_explicit(&c->seekWindow, memory_order_relaxed)];
+    start = atomic_load_explicit(&w->start, memory_order_relaxed);
+    end   = atomic_load_explicit(&w->end, memory_order_relaxed);
+    frame = wrapFrame(play, c->fileFrames);
+
+    mvprintw(25,0,"Position: %d:%06.3f / %d:%06.3f  Cached -%.2fs +%.2fs  Underruns %u\n",
+        (int)(frame / rate) / 60, fmod(frame / rate, 60.0),
+        (int)(c->fileFrames / rate) / 60, fmod(c->fileFrames / rate, 60.0),
+        play > start ? (play - start) / rate : 0.0, end > play ? (end - play) / rate : 0.0,
+        atomic_load_explicit(&c->underruns, memory_order_relaxed));
+    mvprintw(27,0,"Resampler: %s, Callback p99 %d%% of Deadline\n",
+        src_get_name(srcLadder[atomic_load_explicit(&data.governor.playing, memory_order_relaxed)]), atomic_load_explicit(&data.governor.p99, memory_order_relaxed));
+    refresh();
+}
+
+//-----------------------------------------------------------------------------
+// Name: truePeakCoeffs
+// Desc: ITU-R BS.1770-4 Annex 2 4x Oversampling Interpolator, One Row per Phase.
+//       Rows Come in Time-Reversed Pairs so Dotting Them Against the History in
+//       Oldest-to-Newest Order Still Visits Every Phase.
+//-----------------------------------------------------------------------------
+static const float truePeakCoeffs[TRUEPEAK_PHASES][TRUEPEAK_TAPS] = {
+    {  0.0017089843750f,  0.0109863281250f, -0.0196533203125f,  0.0332031250000f,
+      -0.0594482421875f,  0.1373291015625f,  0.9721679687500f, -0.1022949218750f,
+       0.0476074218750f, -0.0266113281250f,  0.0148925781250f, -0.0083007812500f },
+    { -0.0291748046875f,  0.0292968750000f, -0.0517578125000f,  0.0891113281250f,
+      -0.1665039062500f,  0.4650878906250f,  0.7797851562500f, -0.2003173828125f,
+       0.1015625000000f, -0.0582275390625f,  0.0330810546875f, -0.0189208984375f },
+    { -0.0189208984375f,  0.0330810546875f, -0.0582275390625f,  0.1015625000000f,
+      -0.2003173828125f,  0.7797851562500f,  0.4650878906250f, -0.1665039062500f,
+       0.0891113281250f, -0.0517578125000f,  0.0292968750000f, -0.0291748046875f },
+    { -0.0083007812500f,  0.0148925781250f, -0.0266113281250f,  0.0476074218750f,
+      -0.1022949218750f,  0.9721679687500f,  0.1373291015625f, -0.0594482421875f,
+       0.0332031250000f, -0.0196533203125f,  0.0109863281250f,  0.0017089843750f }
+};
+
+//-----------------------------------------------------------------------------
+// Name: energyToLUFS(double meanSquare)
+// Desc: BS.1770 Loudness of a Channel-Summed K-Weighted Mean Square
+//-----------------------------------------------------------------------------
+static double energyToLUFS(double meanSquare)
+{
+    if (meanSquare <= 0) {
+        return LOUDNESS_SILENCE;
+    }
+    return -0.691 + 10.0 * log10(meanSquare);
+}
+
+//-----------------------------------------------------------------------------
+// Name: initialize_loudnessMeter()
+// Desc: Derives the K-Weighting Biquads for sampleRate and Clears All History.
+//       Coefficient Formulas Match the 48kHz Tables in BS.1770 at Any Rate.
+//-----------------------------------------------------------------------------
+void initialize_loudnessMeter(loudnessMeter *m, int sampleRate, int numChannels)
+{
+    double f0, G, Q, K, Vh, Vb, a0;
+
+    memset(m, 0, sizeof(*m));
+    m->numChannels = numChannels;
+    m->hopFrames   = sampleRate * LOUDNESS_HOP_MS / 1000;
+
+    /* Stage 1: High Shelf Modelling the Acoustic Effect of the Head */
+    f0 = 1681.974450955533;
+    G  = 3.999843853973347;
+    Q  = 0.7071752369554196;
+    K  = tan(PI * f0 / sampleRate);
+    Vh = pow(10.0, G / 20.0);
+    Vb = pow(Vh, 0.4996667741545416);
+    a0 = 1.0 + K / Q + K * K;
+
+    m->shelf.b0 = (Vh + Vb * K / Q + K * K) / a0;
+    m->shelf.b1 = 2.0 * (K * K - Vh) / a0;
+    m->shelf.b2 = (Vh - Vb * K / Q + K * K) / a0;
+    m->shelf.a1 = 2.0 * (K * K - 1.0) / a0;
+    m->shelf.a2 = (1.0 - K / Q + K * K) / a0;
+
+    /* Stage 2: Revised Low-Frequency B-Curve Highpass */
+    f0 = 38.13547087602444;
+    Q  = 0.5003270373238773;
+    K  = tan(PI * f0 / sampleRate);
+    a0 = 1.0 + K / Q + K * K;
+
+    m->rlb.b0 =  1.0;
+    m->rlb.b1 = -2.0;
+    m->rlb.b2 =  1.0;
+    m->rlb.a1 = 2.0 * (K * K - 1.0) / a0;
+    m->rlb.a2 = (1.0 - K / Q + K * K) / a0;
+
+    /* Nothing Measured Yet */
+    atomic_store(&m->readings.momentary,  LOUDNESS_SILENCE);
+    atomic_store(&m->readings.shortTerm,  LOUDNESS_SILENCE);
+    atomic_store(&m->readings.integrated, LOUDNESS_SILENCE);
+    atomic_store(&m->readings.truePeak,   LOUDNESS_SILENCE);
+    atomic_store(&m->readings.sequence,   0);
+}
+
+//-----------------------------------------------------------------------------
+// Name: gatedLoudness(const loudnessMeter *m)
+// Desc: Integrated Loudness of the Gating Histogram, Relative Gate Sitting
+//       10 LU Under the Absolute-Gated Mean. Histograms Merged From Several
+//       Meters Gate the Same as One Meter That Saw Everything.
+//-----------------------------------------------------------------------------
+static double gatedLoudness(const loudnessMeter *m)
+{
+    int    bin, start;
+    double threshold, sumEnergy = 0;
+    unsigned int sumCount = 0;
+
+    if (m->gatedCount == 0) {
+        return LOUDNESS_SILENCE;
+    }
+
+    threshold = energyToLUFS(m->gatedEnergy / m->gatedCount) + LOUDNESS_REL_GATE;
+    start = (int)((threshold - LOUDNESS_ABS_GATE) * 10.0);
+    if (start < 0) {
+        start = 0;
+    }
+    for (bin = start; bin < LOUDNESS_HIST_BINS; bin++)
+    {
+        sumEnergy += m->histEnergy[bin];
+        sumCount  += m->histCount[bin];
+    }
+    return sumCount > 0 ? energyToLUFS(sumEnergy / sumCount) : LOUDNESS_SILENCE;
+}
+
+//-----------------------------------------------------------------------------
+// Name: loudnessMeterFinishHop()
+// Desc: Closes a 100ms Hop, Updates Gating Histogram and Publishes Readings
+//-----------------------------------------------------------------------------
+static void loudnessMeterFinishHop(loudnessMeter *m)
+{
+    int    i, bin;
+    double momentary = 0, shortTerm = 0, block;
+
+    /* Store Hop Mean Square in the Short-Term Ring */
+    m->hopHistory[m->hopIndex] = m->hopSum / m->hopFrames;
+    m->hopIndex = (m->hopIndex + 1) % LOUDNESS_SHORTTERM_HOPS;
+    if (m->hopsFilled < LOUDNESS_SHORTTERM_HOPS) {
+        m->hopsFilled++;
+    }
+    m->hopSum   = 0;
+    m->hopCount = 0;
+
+    /* Sum Newest Hops, Momentary Uses the Last 4, Short-Term All 30 */
+    for (i = 0; i < m->hopsFilled; i++)
+    {
+        block = m->hopHistory[(m->hopIndex - 1 - i + LOUDNESS_SHORTTERM_HOPS) % LOUDNESS_SHORTTERM_HOPS];
+        if (i < LOUDNESS_MOMENTARY_HOPS) {
+            momentary += block;
+        }
+        shortTerm += block;
+    }
+    shortTerm /= m->hopsFilled;
+
+    /* Gating Blocks Need a Full 400ms */
+    if (m->hopsFilled >= LOUDNESS_MOMENTARY_HOPS)
+    {
+        momentary /= LOUDNESS_MOMENTARY_HOPS;
+        block = energyToLUFS(momentary);
+
+        /* Absolute Gate, Then File Into the 0.1 LU Histogram */
+        if (block > LOUDNESS_ABS_GATE)
+        {
+            bin = (int)((block - LOUDNESS_ABS_GATE) * 10.0);
+            if (bin >= LOUDNESS_HIST_BINS) {
+                bin = LOUDNESS_HIST_BINS - 1;
+            }
+            m->histEnergy[bin] += momentary;
+            m->histCount[bin]++;
+            m->gatedEnergy += momentary;
+            m->gatedCount++;
+        }
+
+        atomic_store_explicit(&m->readings.momentary, (float)block, memory_order_relaxed);
+    }
+
+    /* Integrated Only Moves Once Something Passed the Gates */
+    block = gatedLoudness(m);
+    if (block > LOUDNESS_SILENCE) {
+        atomic_store_explicit(&m->readings.integrated, (float)block, memory_order_relaxed);
+    }
+
+    atomic_store_explicit(&m->readings.shortTerm, (float)energyToLUFS(shortTerm), memory_order_relaxed);
+    atomic_store_explicit(&m->readings.truePeak,
+        m->tpMax > 0 ? 20.0f * log10f(m->tpMax) : LOUDNESS_SILENCE, memory_order_relaxed);
+    atomic_fetch_add_explicit(&m->readings.sequence, 1, memory_order_release);
+}
+
+//-----------------------------------------------------------------------------
+// Name: loudnessMeterProcess()
+// Desc: K-Weights and Accumulates an Interleaved Block, Tracks 4x True Peak.
+//       Runs Inside the Audio Callback, No Allocation or Locking.
+//-----------------------------------------------------------------------------
+void loudnessMeterProcess(loudnessMeter *m, const float *buffer, int numFrames)
+{
+    int    i, ch, k, n, run;
+    int    numChannels = m->numChannels;
+    double x, y, z, sum;
+    float  peak = m->tpMax;
+    float  phase, *hist;
+    kBiquad *s = &m->shelf, *r = &m->rlb;
+
+    for (n = 0; n < numFrames; n += run)
+    {
+        /* Process Up to the Next Hop Boundary */
+        run = m->hopFrames - m->hopCount;
+        if (run > numFrames - n) {
+            run = numFrames - n;
+        }
+
+        sum = 0;
+        for (i = n; i < n + run; i++)
+        {
+            for (ch = 0; ch < numChannels; ch++)
+            {
+                x = buffer[i * numChannels + ch];
+
+                /* Pre-Filter Shelf */
+                y = s->b0 * x + s->b1 * s->x1[ch] + s->b2 * s->x2[ch]
+                  - s->a1 * s->y1[ch] - s->a2 * s->y2[ch];
+                s->x2[ch] = s->x1[ch]; s->x1[ch] = x;
+                s->y2[ch] = s->y1[ch]; s->y1[ch] = y;
+
+                /* RLB Highpass */
+                z = r->b0 * y + r->b1 * r->x1[ch] + r->b2 * r->x2[ch]
+                  - r->a1 * r->y1[ch] - r->a2 * r->y2[ch];
+                r->x2[ch] = r->x1[ch]; r->x1[ch] = y;
+                r->y2[ch] = r->y1[ch]; r->y1[ch] = z;
+
+                sum += z * z;
+
+                /* True Peak: Each Polyphase Branch is One Interpolated Point */
+                hist = m->tpHistory[ch];
+                hist[m->tpIndex] = hist[m->tpIndex + TRUEPEAK_TAPS] = (float)x;
+                hist += m->tpIndex + 1;
+                for (k = 0; k < TRUEPEAK_PHASES; k++)
+                {
+                    phase = hist[0]  * truePeakCoeffs[k][0]  + hist[1]  * truePeakCoeffs[k][1]
+                          + hist[2]  * truePeakCoeffs[k][2]  + hist[3]  * truePeakCoeffs[k][3]
+                          + hist[4]  * truePeakCoeffs[k][4]  + hist[5]  * truePeakCoeffs[k][5]
+                          + hist[6]  * truePeakCoeffs[k][6]  + hist[7]  * truePeakCoeffs[k][7]
+                          + hist[8]  * truePeakCoeffs[k][8]  + hist[9]  * truePeakCoeffs[k][9]
+                          + hist[10] * truePeakCoeffs[k][10] + hist[11] * truePeakCoeffs[k][11];
+                    phase = fabsf(phase);
+                    if (phase > peak) {
+                        peak = phase;
+                    }
+                }
+                if (fabsf((float)x) > peak) {
+                    peak = fabsf((float)x);
+                }
+            }
+            if (++m->tpIndex == TRUEPEAK_TAPS) {
+                m->tpIndex = 0;
+            }
+        }
+
+        m->hopSum   += sum;
+        m->hopCount += run;
+        m->tpMax     = peak;
+
+        if (m->hopCount == m->hopFrames) {
+            loudnessMeterFinishHop(m);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name: void printGUI() 
+// Desc: Print Updateable GUI
+//-----------------------------------------------------------------------------
+void printGUI() 
+{
+    /* Speed Ratio */
+    mvprintw(14,0,"Speed Ratio: %.2f\n", g_deck->direction * g_deck->src_ratio);
+
+    /* Low Pass Filter */
+    mvprintw(15,0,"LPF: %s\n", g_deck->filterState[(int)g_deck->lpf_On]);
+    mvprintw(16,0,"Frequency: %dhz\n", g_deck->lpf_freq);
+    mvprintw(17,0,"Resonance: %d\n", g_deck->lpf_res);
+
+    /* High Pass Filter */
+    mvprintw(15,20,"HPF: %s\n", g_deck->filterState[(int)g_deck->hpf_On]);
+    mvprintw(16,20,"Frequency: %dhz\n", g_deck->hpf_freq);
+    mvprintw(17,20,"Resonance: %d\n", g_deck->hpf_res);
+
+    /* Ring Channels */
+    mvprintw(14,20,"Rings: %s\n", ringModeNames[g_ring_mode]);
+
+    /* Turntable Motor */
+    mvprintw(18,0,"Motor: %s\n", motorNames[g_deck->motor]);
+
+    /* Filters Near Nyquist Run Oversampled */
+    mvprintw(18,20,"Filter Rate: %dx\n", filterOversampling(g_deck));
+
+    /* Deck the Readout Above Belongs to, and Where the Crossfader Sits */
+    if (deckB.inFile != NULL) {
+        mvprintw(29,0,"Deck: %s  Volume A %.1f B %.1f  Crossfader: %.2f\n", g_deck == &deckB ? "B" : "A",
+            data.amplitude, deckB.amplitude, data.crossfader);
+    }
+    refresh();
+
+    printMeters();
+}
+
+//-----------------------------------------------------------------------------
+// Name: void printMeters() 
+// Desc: Print Loudness Readings, Only Redraws When the Audio Thread Published
+//-----------------------------------------------------------------------------
+void printMeters() 
+{
+    static unsigned int lastSequence = 0;
+    unsigned int sequence;
+    loudnessReadings *r = &data.meter.readings;
+
+    sequence = atomic_load_explicit(&r->sequence, memory_order_acquire);
+    if (sequence == lastSequence) {
+        return;
+    }
+    lastSequence = sequence;
+
+    mvprintw(19,0,"Momentary: %6.1f LUFS  Short-Term: %6.1f LUFS\n",
+        atomic_load_explicit(&r->momentary, memory_order_relaxed),
+        atomic_load_explicit(&r->shortTerm, memory_order_relaxed));
+    mvprintw(20,0,"Integrated: %5.1f LUFS  True Peak: %6.1f dBTP\n",
+        atomic_load_explicit(&r->integrated, memory_order_relaxed),
+        atomic_load_explicit(&r->truePeak, memory_order_relaxed));
+    mvprintw(21,0,"Limiter: %5.1f dB  Latency: %d Frames (%.1f ms)\n",
+        atomic_load_explicit(&data.limiter.gainReduction, memory_order_relaxed),
+        data.limiter.lookahead + OVERSAMPLE_LATENCY,
+        1000.0 * (data.limiter.lookahead + OVERSAMPLE_LATENCY) / data.sfinfo1.samplerate);
+    mvprintw(23,0,"Envelope RMS L %.3f R %.3f  Peak L %.3f R %.3f\n",
+        atomic_load_explicit(&data.envelope.rms[0], memory_order_relaxed),
+        atomic_load_explicit(&data.envelope.rms[data.sfinfo1.channels - 1], memory_order_relaxed),
+        atomic_load_explicit(&data.envelope.peak[0], memory_order_relaxed),
+        atomic_load_explicit(&data.envelope.peak[data.sfinfo1.channels - 1], memory_order_relaxed));
+    refresh();
+}
+
+//-----------------------------------------------------------------------------
+// Name: double getTimeSeconds() 
+// Desc: Monotonic Wall Clock for Benchmarks
+//-----------------------------------------------------------------------------
+double getTimeSeconds() 
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+//-----------------------------------------------------------------------------
+// Name: double getThreadCpuSeconds() 
+// Desc: CPU Time Consumed by the Calling Thread
+//-----------------------------------------------------------------------------
+double getThreadCpuSeconds() 
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+//-----------------------------------------------------------------------------
+// Name: void runBenchmarks() 
+// Desc: Times the Per-Block DSP Against the Real-Time Block Budget
+//-----------------------------------------------------------------------------
+void runBenchmarks() 
+{
+    static float noise[FRAMES_PER_BUFFER * STEREO];
+    static float work[FRAMES_PER_BUFFER * STEREO];
+    double budget = (double)FRAMES_PER_BUFFER / SAMPLING_RATE;
+    double start, elapsed;
+    int    i, blocks = 4000;
+
+    /* Synthetic Full-Scale Noise */
+    srand(1);
+    for (i = 0; i < FRAMES_PER_BUFFER * STEREO; i++) {
+        noise[i] = (float)rand() / RAND_MAX - 0.5f;
+    }
+
+    /* Loudness Meter, Stereo */
+    initialize_loudnessMeter(&data.meter, SAMPLING_RATE, STEREO);
+    start = getTimeSeconds();
+    for (i = 0; i < blocks; i++) {
+        loudnessMeterProcess(&data.meter, noise, FRAMES_PER_BUFFER);
+    }
+    elapsed = (getTimeSeconds() - start) / blocks;
+
+    printf("loudnessMeterProcess: %d frames x %d ch: %.2f us/block, %.2f ns/frame, %.3f%% of block budget\n",
+        FRAMES_PER_BUFFER, STEREO, elapsed * 1e6, elapsed * 1e9 / FRAMES_PER_BUFFER,
+        100.0 * elapsed / budget);
+    printf("  integrated %.1f LUFS, true peak %.1f dBTP\n",
+        atomic_load(&data.meter.readings.integrated), atomic_load(&data.meter.readings.truePeak));
+
+    /* Limiter, Stereo, Noise Boosted so it Always Works */
+    for (i = 0; i < FRAMES_PER_BUFFER * STEREO; i++) {
+        noise[i] *= 4.0f;
+    }
+    initialize_limiter(&data.limiter, SAMPLING_RATE, STEREO, LIMITER_LOOKAHEAD_MS);
+    start = getTimeSeconds();
+    for (i = 0; i < blocks; i++) {
+        memcpy(work, noise, sizeof(work));
+        brickwall(&data.limiter, work, FRAMES_PER_BUFFER);
+    }
+    elapsed = (getTimeSeconds() - start) / blocks;
+
+    printf("brickwall: %d frames x %d ch, %d frame lookahead: %.2f us/block, %.2f ns/frame, %.3f%% of block budget\n",
+        FRAMES_PER_BUFFER, STEREO, data.limiter.lookahead, elapsed * 1e6,
+        elapsed * 1e9 / FRAMES_PER_BUFFER, 100.0 * elapsed / budget);
+
+    /* Visual History, Stereo Deinterleave on the Audio Thread */
+    initialize_channelHistory(&data.history, STEREO);
+    start = getTimeSeconds();
+    for (i = 0; i < blocks; i++) {
+        channelHistoryWrite(&data.history, noise, FRAMES_PER_BUFFER);
+    }
+    elapsed = (getTimeSeconds() - start) / blocks;
+
+    printf("channelHistoryWrite: %d frames x %d ch: %.2f us/block, %.2f ns/frame, %.3f%% of block budget\n",
+        FRAMES_PER_BUFFER, STEREO, elapsed * 1e6, elapsed * 1e9 / FRAMES_PER_BUFFER,
+        100.0 * elapsed / budget);
+
+    /* Ring Geometry, No GL Context Needed */
+    updateRingTable(&g_ring_table, FRAMES_PER_BUFFER);
+    start = getTimeSeconds();
+    for (i = 0; i < blocks; i++) {
+        generateRingGeometry(&g_ring_table, noise, FRAMES_PER_BUFFER, RING_RADIUS, RING_DEPTH,
+                             g_ring_vertices[0], g_ring_vertices[0] + FRAMES_PER_BUFFER * 3);
+    }
+    elapsed = (getTimeSeconds() - start) / blocks;
+
+    printf("generateRingGeometry: %d segments: %.2f us/ring, %.2f ns/vertex\n",
+        FRAMES_PER_BUFFER, elapsed * 1e6, elapsed * 1e9 / FRAMES_PER_BUFFER);
+
+    /* Level of Detail, Window Long Enough That Both 720p and 4K Decimate */
+    for (i = 0; i < 2; i++)
+    {
+        static float window[RING_MAX_SEGMENTS * 4];
+        int height = i ? 2160 : 720;
+        int numVertices = ringLODVertices(RING_MAX_SEGMENTS * 4, height);
+        int j;
+
+        for (j = 0; j < RING_MAX_SEGMENTS * 4; j++) {
+            window[j] = noise[j % (FRAMES_PER_BUFFER * STEREO)];
+        }
+        start = getTimeSeconds();
+        for (j = 0; j < blocks; j++) {
+            ringLOD(window, RING_MAX_SEGMENTS * 4, numVertices, g_ring_vertices[0]);
+        }
+        elapsed = (getTimeSeconds() - start) / blocks;
+
+        printf("decimateMinMax: %d samples to %d vertices at %dp: %.2f us/ring, %.2f ns/sample\n",
+            RING_MAX_SEGMENTS * 4, numVertices, height, elapsed * 1e6, elapsed * 1e9 / (RING_MAX_SEGMENTS * 4));
+    }
+
+    /* Platter at Unity (Bypassed), Steady Varispeed and Spinning Up, Over a Cache Window of Noise */
+    data.sfinfo1.channels   = STEREO;
+    data.sfinfo1.samplerate = SAMPLING_RATE;
+    data.src_state = src_new(SRC_SINC_FASTEST, STEREO, &data.src_error);
+    initialize_SRC_DATA(&data);
+    data.cache.numChannels = STEREO;
+    data.cache.fileFrames  = CACHE_FRAMES;
+    data.cache.windows[0].frames = malloc((size_t)CACHE_FRAMES * STEREO * sizeof(float));
+    for (i = 0; i < CACHE_FRAMES * STEREO; i++) {
+        data.cache.windows[0].frames[i] = noise[i % (FRAMES_PER_BUFFER * STEREO)];
+    }
+    atomic_store(&data.cache.windows[0].start, -((sf_count_t)1 << 40));
+    atomic_store(&data.cache.windows[0].end, (sf_count_t)1 << 40);
+    atomic_store(&data.cache.direction, 1);
+    {
+        double platter[3];
+        int j;
+
+        for (i = 0; i < 3; i++)
+        {
+            data.src_ratio = i ? 0.8 : 1.0;
+            start = getTimeSeconds();
+            for (j = 0; j < blocks; j++)
+            {
+                data.speed = i == 2 ? 0.5 : 1.0 / data.src_ratio;  // Ramping Never Arrives Within a Block
+                platterProcess(&data, FRAMES_PER_BUFFER);
+            }
+            platter[i] = (getTimeSeconds() - start) / blocks;
+        }
+        data.src_ratio = 1.0;
+
+        printf("platterProcess: sinc fastest, %d frames x %d ch: unity %.2f us/block, steady %.2f us/block, ramping %.2f us/block (%.2fx)\n",
+            FRAMES_PER_BUFFER, STEREO, platter[0] * 1e6, platter[1] * 1e6, platter[2] * 1e6, platter[2] / platter[1]);
+    }
+
+    /* Lowpass Either Side of the Oversampling Thresholds */
+    {
+        static const int cutoffs[3] = { 5000, 12000, 20000 };
+        double filters[3];
+        int j;
+
+        initialize_Filters(&data);
+        data.lpf_On = true;
+        for (i = 0; i < 3; i++)
+        {
+            data.lpf_freq = cutoffs[i];
+            start = getTimeSeconds();
+            for (j = 0; j < blocks; j++)
+            {
+                memcpy(data.src_outBuffer, noise, sizeof(noise));
+                filterProcess(&data, FRAMES_PER_BUFFER);
+            }
+            filters[i] = (getTimeSeconds() - start) / blocks;
+        }
+        data.lpf_On = false;
+
+        printf("filterProcess: lowpass, %d frames x %d ch: %d Hz %dx %.2f us/block, %d Hz %dx %.2f us/block, %d Hz %dx %.2f us/block\n",
+            FRAMES_PER_BUFFER, STEREO, cutoffs[0], 1, filters[0] * 1e6, cutoffs[1], 2, filters[1] * 1e6,
+            cutoffs[2], 4, filters[2] * 1e6);
+    }
+    src_delete(data.src_state);
+    free(data.cache.windows[0].frames);
+}
+
+//-----------------------------------------------------------------------------
+// Benchmark Sweep
+//-----------------------------------------------------------------------------
+
+/* One Kernel at One Size, Timed as a Unit */
+typedef struct benchCase {
+    const char  *stage;
+    const char  *variant;                       // Converter or Cutoff, Empty Otherwise
+    int          numFrames;
+    int          numChannels;
+    double       ratio;                         // Output per Input Frame, 1 Outside src_process
+    const float *input;                         // Full-Scale Noise, Interleaved
+    float       *work;                          // Refilled From input by In-Place Kernels
+    void        *state;                         // Limiter, Meter, History, Ring Table or SRC_STATE
+    void       (*kernel)(struct benchCase *bc);
+    volatile float sink;                        // Keeps Pure Kernels From Being Optimized Away
+} benchCase;
+
+//-----------------------------------------------------------------------------
+// Name: bench*(benchCase *bc)
+// Desc: One Call of Each Stage. In-Place Stages Copy Fresh Input First so
+//       Repeated Filtering Never Decays Into Denormals, the "copy" Row is
+//       That Overhead on its Own.
+//-----------------------------------------------------------------------------
+static void benchCopy(benchCase *bc)
+{
+    memcpy(bc->work, bc->input, (size_t)bc->numFrames * bc->numChannels * sizeof(float));
+}
+
+static void benchLowPass(benchCase *bc)
+{
+    benchCopy(bc);
+    lowPassFilter(&data, bc->work, bc->numFrames, bc->numChannels, SAMPLING_RATE, data.lpf_freq, data.lpf_res);
+}
+
+static void benchHighPass(benchCase *bc)
+{
+    benchCopy(bc);
+    highPassFilter(&data, bc->work, bc->numFrames, bc->numChannels, SAMPLING_RATE, data.hpf_freq, data.hpf_res);
+}
+
+static void benchFilterProcess(benchCase *bc)
+{
+    memcpy(data.src_outBuffer, bc->input, (size_t)bc->numFrames * bc->numChannels * sizeof(float));
+    filterProcess(&data, bc->numFrames);
+}
+
+static void benchBrickwall(benchCase *bc)
+{
+    benchCopy(bc);
+    brickwall((peakLimiter*)bc->state, bc->work, bc->numFrames);
+}
+
+static void benchRMS(benchCase *bc)
+{
+    g_buffer_size = bc->numFrames * bc->numChannels;
+    bc->sink = computeRMS((float*)bc->input);
+}
+
+static void benchLoudness(benchCase *bc)
+{
+    loudnessMeterProcess((loudnessMeter*)bc->state, bc->input, bc->numFrames);
+}
+
+static void benchHistory(benchCase *bc)
+{
+    channelHistoryWrite((channelHistory*)bc->state, bc->input, bc->numFrames);
+}
+
+static void benchRingGeometry(benchCase *bc)
+{
+    generateRingGeometry((ringTable*)bc->state, bc->input, bc->numFrames, RING_RADIUS, RING_DEPTH,
+                         g_ring_vertices[0], g_ring_vertices[0] + bc->numFrames * 3);
+}
+
+static void benchResample(benchCase *bc)
+{
+    SRC_DATA block;
+
+    block.data_in       = (float*)bc->input;
+    block.data_out      = bc->work;
+    block.input_frames  = (long)ceil(bc->numFrames / bc->ratio) + 1;
+    block.output_frames = bc->numFrames;
+    block.src_ratio     = bc->ratio;
+    block.end_of_input  = 0;
+    src_process((SRC_STATE*)bc->state, &block);
+}
+
+//-----------------------------------------------------------------------------
+// Name: estimateCoreClock()
+// Desc: Hz From a Chain of Dependent Multiplies of Known Latency. Portable
+//       Where a Cycle Counter Isn't, and Unlike the x86 TSC it Follows Turbo.
+//-----------------------------------------------------------------------------
+static double estimateCoreClock()
+{
+    uint64_t x = 1;
+    double   start, elapsed, best = 0;
+    int      i, t;
+
+    for (t = 0; t < BENCH_TRIALS; t++)
+    {
+        start = getTimeSeconds();
+        for (i = 0; i < BENCH_CLOCK_MULTIPLIES; i += 4)
+        {
+            /* Empty asm Keeps the Compiler From Folding the Chain */
+            x *= 0x9E3779B97F4A7C15ull; __asm__ volatile("" : "+r"(x));
+            x *= 0x9E3779B97F4A7C15ull; __asm__ volatile("" : "+r"(x));
+            x *= 0x9E3779B97F4A7C15ull; __asm__ volatile("" : "+r"(x));
+            x *= 0x9E3779B97F4A7C15ull; __asm__ volatile("" : "+r"(x));
+        }
+        elapsed = getTimeSeconds() - start;
+        if (t == 0 || elapsed < best) {
+            best = elapsed;
+        }
+    }
+    return (double)BENCH_CLOCK_MULTIPLIES * BENCH_MULTIPLY_CYCLES / best;
+}
+
+//-----------------------------------------------------------------------------
+// Name: timeBenchCase(benchCase *bc)
+// Desc: Seconds per Call, Fastest of BENCH_TRIALS. The Repeat Count Doubles
+//       Until One Trial Outlasts the Clock's Resolution by a Wide Margin.
+//-----------------------------------------------------------------------------
+static double timeBenchCase(benchCase *bc)
+{
+    double start, elapsed, best = 0;
+    long   calls = 1, c;
+    int    t;
+
+    for (;;)
+    {
+        start = getTimeSeconds();
+        for (c = 0; c < calls; c++) {
+            bc->kernel(bc);
+        }
+        if (getTimeSeconds() - start >= BENCH_TRIAL_SECONDS) {
+            break;
+        }
+        calls *= 2;
+    }
+
+    for (t = 0; t < BENCH_TRIALS; t++)
+    {
+        start = getTimeSeconds();
+        for (c = 0; c < calls; c++) {
+            bc->kernel(bc);
+        }
+        elapsed = (getTimeSeconds() - start) / calls;
+        if (t == 0 || elapsed < best) {
+            best = elapsed;
+        }
+    }
+    return best;
+}
+
+//-----------------------------------------------------------------------------
+// Name: benchStage()
+// Desc: Times One Stage at the Case's Size and Writes its Row or Object.
+//       A Sample is One Channel of One Frame, Output Frames for src_process.
+//-----------------------------------------------------------------------------
+static void benchStage(FILE *fp, bool json, int *rows, benchCase *bc, const char *stage,
+                       void (*kernel)(benchCase*), void *state, double hz)
+{
+    double perSample;
+
+    bc->stage  = stage;
+    bc->kernel = kernel;
+    bc->state  = state;
+    perSample  = timeBenchCase(bc) / ((double)bc->numFrames * bc->numChannels);
+
+    if (json)
+    {
+        fprintf(fp, "%s  {\"stage\": \"%s\", \"variant\": \"%s\", \"frames\": %d, \"channels\": %d, "
+                    "\"ratio\": %.4f, \"ns_per_sample\": %.4f, \"cycles_per_sample\": %.3f, \"clock_ghz\": %.3f}",
+            *rows ? ",\n" : "", bc->stage, bc->variant, bc->numFrames, bc->numChannels, bc->ratio,
+            perSample * 1e9, perSample * hz, hz * 1e-9);
+    }
+    else
+    {
+        fprintf(fp, "%s,%s,%d,%d,%.4f,%.4f,%.3f,%.3f\n", bc->stage, bc->variant, bc->numFrames,
+            bc->numChannels, bc->ratio, perSample * 1e9, perSample * hz, hz * 1e-9);
+    }
+    fflush(fp);
+    (*rows)++;
+}
+
+//-----------------------------------------------------------------------------
+// Name: int runBenchSweep()
+// Desc: Every DSP Stage Over 64-4096 Frame Blocks, Mono and Stereo, and the
+//       Resampler Ladder Over a Spread of Ratios, on Synthetic Noise. One CSV
+//       Row or JSON Object per Case With ns and Cycles per Sample.
+//-----------------------------------------------------------------------------
+int runBenchSweep()
+{
+    static float noise[BENCH_MAX_INPUT * STEREO];
+    static float work[BENCH_MAX_FRAMES * STEREO];
+    static peakLimiter    limiter;
+    static loudnessMeter  meter;
+    static channelHistory history;
+    static ringTable      table;
+    static const double   ratios[5]  = { BENCH_MIN_RATIO, 0.8, 1.0, 1.25, 2.0 };
+    static const int      cutoffs[3] = { 5000, 12000, 20000 };
+    char      variant[32];
+    benchCase bc;
+    SRC_STATE *state;
+    FILE  *fp = stdout;
+    double hz, start;
+    bool   json = g_options.analyzeJson;
+    int    i, k, numChannels, numFrames, error, rows = 0, bufferSize = g_buffer_size;
+
+    if (g_options.analyzeOut != NULL && (fp = fopen(g_options.analyzeOut, "w")) == NULL)
+    {
+        fprintf(stderr, "Error, Couldn't Create %s\n", g_options.analyzeOut);
+        return EXIT_FAILURE;
+    }
+
+    /* Full-Scale Noise, so the Limiter Always Works */
+    srand(1);
+    for (i = 0; i < (int)(sizeof(noise) / sizeof(noise[0])); i++) {
+        noise[i] = 2.0f * rand() / RAND_MAX - 1.0f;
+    }
+
+    start = getTimeSeconds();
+    hz    = estimateCoreClock();
+
+    if (json) {
+        fprintf(fp, "[\n");
+    }
+    else {
+        fprintf(fp, "stage,variant,frames,channels,ratio,ns_per_sample,cycles_per_sample,clock_ghz\n");
+    }
+
+    memset(&bc, 0, sizeof(bc));
+    bc.input   = noise;
+    bc.work    = work;
+    bc.ratio   = 1.0;
+    bc.variant = "";
+
+    initialize_Filters(&data);
+    data.lpf_freq = 5000;
+    data.hpf_freq = 200;
+    data.sfinfo1.samplerate = SAMPLING_RATE;
+
+    for (numChannels = MONO; numChannels <= STEREO; numChannels++)
+    {
+        bc.numChannels = numChannels;
+        data.sfinfo1.channels = numChannels;
+        initialize_limiter(&limiter, SAMPLING_RATE, numChannels, LIMITER_LOOKAHEAD_MS);
+        initialize_loudnessMeter(&meter, SAMPLING_RATE, numChannels);
+        initialize_channelHistory(&history, numChannels);
+
+        for (numFrames = BENCH_MIN_FRAMES; numFrames <= BENCH_MAX_FRAMES; numFrames *= 2)
+        {
+            bc.numFrames = numFrames;
+            benchStage(fp, json, &rows, &bc, "copy", benchCopy, NULL, hz);
+            benchStage(fp, json, &rows, &bc, "lowPassFilter", benchLowPass, NULL, hz);
+            benchStage(fp, json, &rows, &bc, "highPassFilter", benchHighPass, NULL, hz);
+            benchStage(fp, json, &rows, &bc, "brickwall", benchBrickwall, &limiter, hz);
+            benchStage(fp, json, &rows, &bc, "computeRMS", benchRMS, NULL, hz);
+            benchStage(fp, json, &rows, &bc, "loudnessMeterProcess", benchLoudness, &meter, hz);
+            benchStage(fp, json, &rows, &bc, "channelHistoryWrite", benchHistory, &history, hz);
+
+            /* The Oversampler's Buffers Hold One Engine Block */
+            if (numFrames <= FRAMES_PER_BUFFER)
+            {
+                data.lpf_On = true;
+                for (k = 0; k < 3; k++)
+                {
+                    data.lpf_freq = cutoffs[k];
+                    snprintf(variant, sizeof(variant), "lowpass %d Hz %dx", cutoffs[k], filterOversampling(&data));
+                    bc.variant = variant;
+                    benchStage(fp, json, &rows, &bc, "filterProcess", benchFilterProcess, NULL, hz);
+                }
+                bc.variant = "";
+                data.lpf_freq = 5000;
+                data.lpf_On = false;
+            }
+
+            /* One Ring per Channel, Vertices Rather Than Samples */
+            if (numChannels == MONO)
+            {
+                updateRingTable(&table, numFrames);
+                benchStage(fp, json, &rows, &bc, "generateRingGeometry", benchRingGeometry, &table, hz);
+            }
+        }
+
+        /* Whole Ladder, Each Converter Running Steadily at Each Ratio */
+        for (k = 0; k < GOVERNOR_LEVELS; k++)
+        {
+            if ((state = src_new(srcLadder[k], numChannels, &error)) == NULL)
+            {
+                fprintf(stderr, "Error, %s: %s\n", src_get_name(srcLadder[k]), src_strerror(error));
+                continue;
+            }
+            bc.variant = src_get_name(srcLadder[k]);
+            for (i = 0; i < 5; i++)
+            {
+                bc.ratio = ratios[i];
+                for (numFrames = BENCH_MIN_FRAMES; numFrames <= BENCH_MAX_FRAMES; numFrames *= 2)
+                {
+                    bc.numFrames = numFrames;
+                    benchStage(fp, json, &rows, &bc, "src_process", benchResample, state, hz);
+                }
+            }
+            src_delete(state);
+            bc.variant = "";
+            bc.ratio   = 1.0;
+        }
+    }
+
+    if (json) {
+        fprintf(fp, "\n]\n");
+    }
+    if (fp != stdout) {
+        fclose(fp);
+    }
+    g_buffer_size = bufferSize;
+
+    fprintf(stderr, "Benchmark Sweep: %d Cases in %.1fs, Core Clock Estimated at %.2f GHz\n",
+        rows, getTimeSeconds() - start, hz * 1e-9);
+    return EXIT_SUCCESS;
+}
+
+//-----------------------------------------------------------------------------
+// Golden-Output Regression
+//-----------------------------------------------------------------------------
+
+/* A Fixed Parameter Script, Run on the Control Side Before Every Block */
+typedef struct {
+    const char *name;
+    bool        fromFile;                       // Decode-and-Resample Path Used Without a Cache
+    bool        twoDecks;                       // Deck B Plays the Input Too, Through the Crossfader
+    void      (*script)(paData *d, double seconds);     // NULL Plays the --play-automation File
+} goldenScenario;
+
+//-----------------------------------------------------------------------------
+// Name: golden*(paData *d, double seconds)
+// Desc: The Scripts. Each Sets Controls the Way the Keyboard Would, From the
+//       Time at the Start of the Block.
+//-----------------------------------------------------------------------------
+static void goldenUnity(paData *d, double seconds)
+{
+    (void)d;
+    (void)seconds;
+}
+
+static void goldenRatioSweep(paData *d, double seconds)
+{
+    /* Spin Up, Slow Down, Reverse, Brake to a Stop and Start Again, Ending at Unity */
+    d->src_ratio = seconds < 0.5 ? 1.0 : seconds < 1.5 ? 0.5 : seconds < 2.5 ? 1.6 : 1.0;
+    d->direction = seconds >= 3.0 && seconds < 3.8 ? -1 : 1;
+    d->motor     = seconds >= 4.0 && seconds < 4.4 ? PLATTER_MOTOR_BRAKE : PLATTER_MOTOR_ON;
+}
+
+static void goldenFileVarispeed(paData *d, double seconds)
+{
+    d->src_ratio = seconds < 1.5 ? 0.8 : seconds < 2.5 ? 1.0 : seconds < 4.0 ? 1.25 : 0.5;
+}
+
+static void goldenLowpassSweep(paData *d, double seconds)
+{
+    /* 20kHz Down to 20Hz, Through Both Oversampling Thresholds */
+    d->lpf_On   = true;
+    d->lpf_freq = (int)(20000.0 * pow(0.001, seconds / GOLDEN_SECONDS));
+}
+
+static void goldenHighpassSweep(paData *d, double seconds)
+{
+    d->hpf_On   = true;
+    d->hpf_freq = (int)(20.0 * pow(1000.0, seconds / GOLDEN_SECONDS));
+}
+
+static void goldenTwoDecks(paData *d, double seconds)
+{
+    /* Deck B Slow Then Fast Under a Crossfader Sweep, Cut Back Hard at the End */
+    deckB.src_ratio = seconds < 2.0 ? 0.75 : 1.25;
+    deckB.amplitude = 0.8f;
+    d->crossfader   = seconds < 4.0 ? seconds / 4.0 : 0.25;
+}
+
+static void goldenResonance(paData *d, double seconds)
+{
+    /* Both Filters at Full Resonance, the Lowpass Sweeping Down Then the Highpass Up */
+    double half = seconds / (GOLDEN_SECONDS / 2);
+
+    d->lpf_res  = 10;
+    d->hpf_res  = 10;
+    d->lpf_On   = half < 1;
+    d->hpf_On   = half >= 1;
+    d->lpf_freq = (int)(20000.0 * pow(0.01, fmin(half, 1)));
+    d->hpf_freq = (int)(20.0 * pow(500.0, fmax(half - 1, 0)));
+}
+
+//-----------------------------------------------------------------------------
+// Name: generateGoldenInput(float *frames)
+// Desc: CACHE_FRAMES of Stereo: a 20Hz-20kHz Log Sweep on the Left, Noise, a
+//       1kHz Tone and a Click Every Half Second on the Right. The Noise Comes
+//       From xorshift Rather Than rand() so Every libc Writes the Same File.
+//-----------------------------------------------------------------------------
+static void generateGoldenInput(float *frames)
+{
+    double seconds = (double)CACHE_FRAMES / SAMPLING_RATE, rate = log(1000.0), t;
+    uint32_t noise = 2463534242u;
+    int i;
+
+    for (i = 0; i < CACHE_FRAMES; i++)
+    {
+        t = (double)i / SAMPLING_RATE;
+        noise ^= noise << 13;
+        noise ^= noise >> 17;
+        noise ^= noise << 5;
+
+        frames[2 * i]     = (float)(0.5 * sin(2 * PI * 20.0 * seconds / rate * (exp(t / seconds * rate) - 1)));
+        frames[2 * i + 1] = (float)(0.25 * (noise / 2147483648.0 - 1) + 0.25 * sin(2 * PI * 1000.0 * t)
+                                    + (i % (SAMPLING_RATE / 2) == 0 ? 0.45 : 0));
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name: resetGoldenDeck(paData *d, bool fromFile)
+// Desc: One Deck Back to the Top of the Input With Fresh Converters, Filters
+//       and Platter
+//-----------------------------------------------------------------------------
+static void resetGoldenDeck(paData *d, bool fromFile)
+{
+    srcGovernor *g = &d->governor;
+    int i;
+
+    for (i = g->ceiling; i < GOVERNOR_LEVELS; i++) {
+        src_reset(g->states[i]);
+    }
+    g->origin = 0;
+    g->heard  = 0;
+    g->fresh  = true;
+
+    initialize_SRC_DATA(d);
+    initialize_Filters(d);
+    d->amplitude = INITIAL_VOLUME;
+    d->bypassed  = false;
+    memset(d->lpfState, 0, sizeof(d->lpfState));
+    memset(d->hpfState, 0, sizeof(d->hpfState));
+    initialize_channelHistory(&d->history, d->sfinfo1.channels);
+    initialize_envelopeFollower(&d->envelope, d->sfinfo1.samplerate, d->sfinfo1.channels);
+
+    /* The Platter Reads the Whole Input From Memory, Seeks Published Inline */
+    d->cache.running     = !fromFile;
+    d->cache.synchronous = true;
+    d->cache.window      = 0;
+    d->cache.position    = 0;
+    d->cache.seekSeen    = d->cache.handled = d->cache.published = 0;
+    d->cache.current     = 0;
+    atomic_store(&d->cache.seekRequests, 0);
+    atomic_store(&d->cache.seekPublished, 0);
+    atomic_store(&d->cache.seekApplied, 0);
+    atomic_store(&d->cache.playPosition, 0);
+    atomic_store(&d->cache.direction, 1);
+    atomic_store(&d->scratching, false);
+    atomic_store(&d->scratchSpeed, 0.0);
+    sf_seek(d->inFile, 0, SEEK_SET);
+    atomic_store(&d->playhead, 0);
+}
+
+//-----------------------------------------------------------------------------
+// Name: resetGoldenEngine(const goldenScenario *scenario)
+// Desc: Every Scenario Starts From the Top of the Input With Fresh State,
+//       Nothing Carries Over so Each Renders the Same Alone or in the Set.
+//       Deck B and the Automation Script Only Play in Their Scenarios.
+//-----------------------------------------------------------------------------
+static void resetGoldenEngine(const goldenScenario *scenario)
+{
+    automation *a = &data.automation;
+
+    resetGoldenDeck(&data, scenario->fromFile);
+    if (deckB.inFile != NULL) {
+        resetGoldenDeck(&deckB, scenario->fromFile);
+    }
+    data.crossfader  = CROSSFADER_CENTER;
+    data.mixGains[0] = cos(CROSSFADER_CENTER * PI / 2);
+    data.mixGains[1] = sin(CROSSFADER_CENTER * PI / 2);
+    initialize_limiter(&data.limiter, data.sfinfo1.samplerate, data.sfinfo1.channels, g_options.lookahead_ms);
+    initialize_loudnessMeter(&data.meter, data.sfinfo1.samplerate, data.sfinfo1.channels);
+
+    /* Same Output Frames Every Time the Script Plays */
+    a->frame      = 0;
+    a->scriptNext = scenario->script == NULL ? 0 : a->scriptLength;
+    atomic_store(&a->played, 0);
+}
+
+//-----------------------------------------------------------------------------
+// Name: compareGolden()
+// Desc: calc_snr Style: Reference Power Over Difference Power, and the Worst
+//       Single Sample Difference in dBFS. Identical Output is +inf / -inf.
+//-----------------------------------------------------------------------------
+static void compareGolden(const float *out, const float *golden, long numSamples, double *snr, double *peakError)
+{
+    double signal = 0, noise = 0, diff, peak = 0;
+    long i;
+
+    for (i = 0; i < numSamples; i++)
+    {
+        diff    = (double)out[i] - golden[i];
+        signal += (double)golden[i] * golden[i];
+        noise  += diff * diff;
+        if (fabs(diff) > peak) {
+            peak = fabs(diff);
+        }
+    }
+    *snr       = noise > 0 ? 10 * log10(signal / noise) : INFINITY;
+    *peakError = peak > 0 ? 20 * log10(peak) : -INFINITY;
+}
+
+//-----------------------------------------------------------------------------
+// Name: int runGolden(const char* dir)
+// Desc: Renders dir/input.wav Through Every Scenario, Faster Than Realtime
+//       Through the Same automationProcess() as Playback and Export. --record
+//       Writes dir/<scenario>.wav, Otherwise Each Render Must Match its
+//       Golden to Within --snr and --peak-error. The Converter and Lookahead
+//       are Stored in the Golden and Must Match Too. A --play-automation File
+//       Runs Last as One More Scenario, Named After the File, With Deck B
+//       Playing the Input Too if the Script Touches it or the Crossfader.
+//-----------------------------------------------------------------------------
+int runGolden(const char* dir)
+{
+    goldenScenario scenarios[] = {
+        { "unity",              false, false, goldenUnity },
+        { "ratio_sweep",        false, false, goldenRatioSweep },
+        { "file_varispeed",     true,  false, goldenFileVarispeed },
+        { "lowpass_sweep",      false, false, goldenLowpassSweep },
+        { "highpass_sweep",     false, false, goldenHighpassSweep },
+        { "resonance_extremes", false, false, goldenResonance },
+        { "two_decks",          false, true,  goldenTwoDecks },
+        { NULL,                 false, false, NULL },       // --play-automation
+    };
+    int     numScenarios = sizeof(scenarios) / sizeof(scenarios[0]) - 1;
+    int     converter = g_options.src_type >= 0 ? g_options.src_type : SRC_SINC_BEST_QUALITY;
+    char    path[4096], settings[128], scriptName[256], *dot;
+    const char *stored, *base;
+    float  *output, *golden;
+    SNDFILE *file, *deckFile;
+    SF_INFO  info;
+    long    block, numBlocks = (long)ceil(GOLDEN_SECONDS * SAMPLING_RATE / FRAMES_PER_BUFFER);
+    long    numFrames = numBlocks * FRAMES_PER_BUFFER;
+    double  start, elapsed, snr, peakError;
+    int     i, j, failures = 0;
+    bool    pass;
+
+    if (g_options.goldenRecord && mkdir(dir, 0755) != 0 && errno != EEXIST)
+    {
+        printf("Error, Couldn't Create %s\n", dir);
+        return EXIT_FAILURE;
+    }
+
+    /* A Recorded Performance Becomes a Scenario of its Own */
+    if (g_options.automationPlay != NULL)
+    {
+        if (!initialize_automation(&data.automation, NULL, g_options.automationPlay)) {
+            return EXIT_FAILURE;
+        }
+        base = strrchr(g_options.automationPlay, '/');
+        snprintf(scriptName, sizeof(scriptName), "%s", base != NULL ? base + 1 : g_options.automationPlay);
+        if ((dot = strrchr(scriptName, '.')) != NULL && dot != scriptName) {
+            *dot = '\0';
+        }
+        scenarios[numScenarios].name = scriptName;
+
+        /* Deck B Only Plays When the Script Moves it or the Crossfader */
+        for (j = 0; j < data.automation.scriptLength; j++) {
+            scenarios[numScenarios].twoDecks |= data.automation.script[j].deck ||
+                                                data.automation.script[j].control == AUTO_CROSSFADER;
+        }
+        numScenarios++;
+    }
+
+    /* Reference Input, Written Once so Later Goldens Render the Same Audio */
+    data.cache.numChannels = STEREO;
+    data.cache.fileFrames  = CACHE_FRAMES;
+    data.cache.windows[0].frames = malloc((size_t)CACHE_FRAMES * STEREO * sizeof(float));
+    if (data.cache.windows[0].frames == NULL)
+    {
+        printf("Error, Out of Memory for the Golden Input\n");
+        return EXIT_FAILURE;
+    }
+    snprintf(path, sizeof(path), "%s/%s", dir, GOLDEN_INPUT);
+
+    memset(&info, 0, sizeof(info));
+    file = g_options.goldenRecord ? sf_open(path, SFM_READ, &info) : NULL;
+    if (g_options.goldenRecord && file == NULL)
+    {
+        generateGoldenInput(data.cache.windows[0].frames);
+        info.samplerate = SAMPLING_RATE;
+        info.channels   = STEREO;
+        info.format     = SF_FORMAT_WAV | SF_FORMAT_FLOAT;
+        if ((file = sf_open(path, SFM_WRITE, &info)) == NULL)
+        {
+            printf("Error, Couldn't Open %s\n", path);
+            return EXIT_FAILURE;
+        }
+        sf_writef_float(file, data.cache.windows[0].frames, CACHE_FRAMES);
+        sf_close(file);
+        printf("Generated %s\n", path);
+        memset(&info, 0, sizeof(info));
+    }
+    else if (file != NULL) {
+        sf_close(file);
+    }
+
+    if ((data.inFile = sf_open(path, SFM_READ, &data.sfinfo1)) == NULL ||
+        data.sfinfo1.frames != CACHE_FRAMES || data.sfinfo1.channels != STEREO ||
+        data.sfinfo1.samplerate != SAMPLING_RATE)
+    {
+        printf("Error, %s Must be %d Frames of Stereo at %dHz, --record Generates One\n",
+            path, CACHE_FRAMES, SAMPLING_RATE);
+        return EXIT_FAILURE;
+    }
+    sf_readf_float(data.inFile, data.cache.windows[0].frames, CACHE_FRAMES);
+    atomic_store(&data.cache.windows[0].start, -((sf_count_t)1 << 40));
+    atomic_store(&data.cache.windows[0].end, (sf_count_t)1 << 40);
+
+    /* Deck B Plays the Same Input From the Same Memory, Without a Worker Thread */
+    if ((deckFile = sf_open(path, SFM_READ, &deckB.sfinfo1)) == NULL)
+    {
+        printf("Error, Couldn't Open %s\n", path);
+        sf_close(data.inFile);
+        free(data.cache.windows[0].frames);
+        return EXIT_FAILURE;
+    }
+    deckB.cache.numChannels = STEREO;
+    deckB.cache.fileFrames  = CACHE_FRAMES;
+    deckB.cache.windows[0].frames = data.cache.windows[0].frames;
+    atomic_store(&deckB.cache.windows[0].start, -((sf_count_t)1 << 40));
+    atomic_store(&deckB.cache.windows[0].end, (sf_count_t)1 << 40);
+    g_deck_worker.deck = &deckB;
+
+    /* Same Converter Every Run, the Governor Never Observes so Never Switches */
+    initialize_governor(&data.governor, converter, STEREO, SAMPLING_RATE);
+    data.src_state = data.governor.states[data.governor.level];
+    initialize_governor(&deckB.governor, converter, STEREO, SAMPLING_RATE);
+    deckB.src_state = deckB.governor.states[deckB.governor.level];
+    snprintf(settings, sizeof(settings), "%s, %.2fms Lookahead", src_get_name(converter), g_options.lookahead_ms);
+
+    output = malloc((size_t)numFrames * STEREO * sizeof(float));
+    golden = malloc((size_t)numFrames * STEREO * sizeof(float));
+    if (output == NULL || golden == NULL)
+    {
+        printf("Error, Out of Memory for %.1fs Renders\n", (double)numFrames / SAMPLING_RATE);
+        stop_governor(&data.governor);
+        stop_governor(&deckB.governor);
+        sf_close(data.inFile);
+        sf_close(deckFile);
+        free(data.cache.windows[0].frames);
+        free(output);
+        free(golden);
+        return EXIT_FAILURE;
+    }
+    printf("%s: %d Scenarios, %.1fs Each, %s\n", g_options.goldenRecord ? "Recording" : "Comparing",
+        numScenarios, (double)numFrames / SAMPLING_RATE, settings);
+
+    for (i = 0; i < numScenarios; i++)
+    {
+        deckB.inFile = scenarios[i].twoDecks ? deckFile : NULL;
+        resetGoldenEngine(&scenarios[i]);
+        start = getTimeSeconds();
+        for (block = 0; block < numBlocks; block++)
+        {
+            if (scenarios[i].script != NULL) {
+                scenarios[i].script(&data, (double)block * FRAMES_PER_BUFFER / SAMPLING_RATE);
+            }
+            automationProcess(&data, output + block * FRAMES_PER_BUFFER * STEREO, FRAMES_PER_BUFFER);
+        }
+        elapsed = getTimeSeconds() - start;
+
+        snprintf(path, sizeof(path), "%s/%s.wav", dir, scenarios[i].name);
+        memset(&info, 0, sizeof(info));
+
+        if (g_options.goldenRecord)
+        {
+            info.samplerate = SAMPLING_RATE;
+            info.channels   = STEREO;
+            info.format     = SF_FORMAT_WAV | SF_FORMAT_FLOAT;
+            if ((file = sf_open(path, SFM_WRITE, &info)) == NULL)
+            {
+                printf("Error, Couldn't Open %s\n", path);
+                failures++;
+                continue;
+            }
+            sf_set_string(file, SF_STR_COMMENT, settings);
+            sf_writef_float(file, output, numFrames);
+            sf_close(file);
+            printf("  %-20s Recorded, %.0fx Realtime\n", scenarios[i].name, (double)numFrames / SAMPLING_RATE / elapsed);
+            continue;
+        }
+
+        /* A Golden From Other Settings Would Fail for the Wrong Reason */
+        if ((file = sf_open(path, SFM_READ, &info)) == NULL)
+        {
+            printf("  %-20s FAIL, No Golden at %s\n", scenarios[i].name, path);
+            failures++;
+            continue;
+        }
+        stored = sf_get_string(file, SF_STR_COMMENT);
+        if (info.frames != numFrames || info.channels != STEREO || stored == NULL || strcmp(stored, settings) != 0)
+        {
+            printf("  %-20s FAIL, Golden Was Rendered With %s\n", scenarios[i].name, stored != NULL ? stored : "Other Settings");
+            sf_close(file);
+            failures++;
+            continue;
+        }
+        sf_readf_float(file, golden, numFrames);
+        sf_close(file);
+
+        compareGolden(output, golden, numFrames * STEREO, &snr, &peakError);
+        pass = snr >= g_options.goldenSNR && peakError <= g_options.goldenPeakError;
+        failures += !pass;
+        printf("  %-20s %s, SNR %6.1f dB, Peak Error %7.1f dBFS, %.0fx Realtime\n", scenarios[i].name,
+            pass ? "pass" : "FAIL", snr, peakError, (double)numFrames / SAMPLING_RATE / elapsed);
+    }
+
+    if (!g_options.goldenRecord) {
+        printf("%d of %d Scenarios Match (SNR >= %.1f dB, Peak Error <= %.1f dBFS)\n", numScenarios - failures,
+            numScenarios, g_options.goldenSNR, g_options.goldenPeakError);
+    }
+
+    data.cache.running  = false;
+    deckB.cache.running = false;
+    deckB.inFile = NULL;
+    stop_automation(&data.automation);
+    stop_governor(&data.governor);
+    stop_governor(&deckB.governor);
+    sf_close(data.inFile);
+    sf_close(deckFile);
+    free(data.cache.windows[0].frames);
+    free(output);
+    free(golden);
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+//-----------------------------------------------------------------------------
+// Real-Time Setup
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Name: reportRealtime()
+// Desc: One Line of the Startup Report, to the Terminal and the Log File
+//-----------------------------------------------------------------------------
+void reportRealtime(const char *format, ...)
+{
+    va_list args;
+
+    va_start(args, format);
+    printf("Realtime: ");
+    vprintf(format, args);
+    printf("\n");
+    va_end(args);
+
+    if (g_log.file != NULL)
+    {
+        va_start(args, format);
+        fprintf(g_log.file, "Realtime: ");
+        vfprintf(g_log.file, format, args);
+        fprintf(g_log.file, "\n");
+        fflush(g_log.file);
+        va_end(args);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name: prefaultMemory(void *buffer, size_t size)
+// Desc: Writes One Byte per Page so Nothing Faults Later on the Audio Thread
+//-----------------------------------------------------------------------------
+size_t prefaultMemory(void *buffer, size_t size)
+{
+    volatile char *bytes = (volatile char*)buffer;
+    size_t page = (size_t)sysconf(_SC_PAGESIZE), i;
+
+    if (buffer == NULL || !g_options.lock_memory) {
+        return 0;
+    }
+    for (i = 0; i < size; i += page) {
+        bytes[i] = bytes[i];
+    }
+    if (size > 0) {
+        bytes[size - 1] = bytes[size - 1];
+    }
+    return size;
+}
+
+#if defined(__linux__)
+//-----------------------------------------------------------------------------
+// Name: parseCpuList(const char *list, cpu_set_t *set)
+// Desc: "0-3,6" Style Lists, false on Anything Else
+//-----------------------------------------------------------------------------
+static bool parseCpuList(const char *list, cpu_set_t *set)
+{
+    const char *p = list;
+    char *end;
+    long  first, last, cpu;
+
+    CPU_ZERO(set);
+    while (*p != '\0')
+    {
+        first = last = strtol(p, &end, 10);
+        if (end == p || first < 0) {
+            return false;
+        }
+        if (*end == '-' && (last = strtol(end + 1, &end, 10)) < first) {
+            return false;
+        }
+        if (*end != ',' && *end != '\0') {
+            return false;
+        }
+        for (cpu = first; cpu <= last && cpu < CPU_SETSIZE; cpu++) {
+            CPU_SET(cpu, set);
+        }
+        p = *end == ',' ? end + 1 : end;
+    }
+    return CPU_COUNT(set) > 0;
+}
+#endif
+
+//-----------------------------------------------------------------------------
+// Name: pinThread(pthread_t thread, int role)
+// Desc: Restricts a Thread to its Role's --affinity CPU List. Only the First
+//       Thread of a Role is Reported, the Rest Follow it Quietly.
+//-----------------------------------------------------------------------------
+void pinThread(pthread_t thread, int role)
+{
+    static const char* roleNames[RT_THREAD_COUNT] = { "Audio", "Reader", "Analysis", "Render" };
+    static bool reported[RT_THREAD_COUNT];
+    const char *list = g_options.affinity[role];
+#if defined(__linux__)
+    cpu_set_t set;
+    int err;
+#endif
+
+    if (list == NULL) {
+        return;
+    }
+
+#if defined(__linux__)
+    if (!parseCpuList(list, &set)) {
+        err = EINVAL;
+    }
+    else {
+        err = pthread_setaffinity_np(thread, sizeof(set), &set);
+    }
+
+    if (!reported[role])
+    {
+        if (err != 0) {
+            reportRealtime("%s Thread Not Pinned to CPUs %s: %s", roleNames[role], list, strerror(err));
+        }
+        else {
+            reportRealtime("%s Thread Pinned to CPUs %s", roleNames[role], list);
+        }
+    }
+#else
+    (void)thread;
+    if (!reported[role]) {
+        reportRealtime("%s Thread Not Pinned, CPU Affinity is Linux Only", roleNames[role]);
+    }
+#endif
+    reported[role] = true;
+}
+
+//-----------------------------------------------------------------------------
+// Name: initialize_realtime()
+// Desc: Locks Current and Future Pages and Pins the Render Thread, Before the
+//       Stream Starts So the Audio Thread Never Waits on a Page In
+//-----------------------------------------------------------------------------
+void initialize_realtime()
+{
+    size_t touched;
+
+    if (g_options.lock_memory)
+    {
+        if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+            reportRealtime("Memory Not Locked, mlockall Failed: %s", strerror(errno));
+        }
+        else
+        {
+            touched = prefaultMemory(&data, sizeof(data)) + prefaultMemory(&g_log, sizeof(g_log));
+            reportRealtime("Memory Locked, %.1f MB of Engine State Prefaulted", touched / 1048576.0);
+        }
+    }
+    else {
+        reportRealtime("Memory Not Locked (Enable With --mlock)");
+    }
+
+    /* The GLUT Thread is This One */
+    pinThread(pthread_self(), RT_THREAD_RENDER);
+}
+
+//-----------------------------------------------------------------------------
+// Name: promoteAudioThread()
+// Desc: The Callback Publishes its Own Thread on its First Block, Then This
+//       Raises its Priority and Pins it From Outside, so the Callback Itself
+//       Never Makes the System Calls
+//-----------------------------------------------------------------------------
+void promoteAudioThread()
+{
+    static const char* policyNames[] = { "SCHED_FIFO", "SCHED_RR" };
+    struct sched_param param;
+    double deadline = getTimeSeconds() + RT_WAIT_MS / 1000.0;
+    int err;
+
+    while (!atomic_load_explicit(&g_audio_thread_known, memory_order_acquire))
+    {
+        if (getTimeSeconds() > deadline)
+        {
+            reportRealtime("Audio Thread Never Called Back, Left As Is");
+            return;
+        }
+        SLEEP( 1 );
+    }
+
+    if (g_options.rt_policy == SCHED_OTHER) {
+        reportRealtime("Audio Thread Left at Normal Priority (Enable With --sched fifo|rr)");
+    }
+    else
+    {
+        memset(&param, 0, sizeof(param));
+        param.sched_priority = g_options.rt_priority;
+        if ((err = pthread_setschedparam(g_audio_thread, g_options.rt_policy, &param)) != 0) {
+            reportRealtime("Audio Thread Not Promoted to %s %d: %s",
+                policyNames[g_options.rt_policy == SCHED_RR], g_options.rt_priority, strerror(err));
+        }
+        else {
+            reportRealtime("Audio Thread Running %s Priority %d",
+                policyNames[g_options.rt_policy == SCHED_RR], g_options.rt_priority);
+        }
+    }
+
+    pinThread(g_audio_thread, RT_THREAD_AUDIO);
+}
+
+//-----------------------------------------------------------------------------
+// Event Log
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Name: postEvent()
+// Desc: Audio Thread: Queues a Fixed-Size Record, No Formatting, Locks or
+//       System Calls. A Full Ring Counts the Event as Dropped Instead.
+//-----------------------------------------------------------------------------
+void postEvent(int code, int detail, sf_count_t position)
+{
+    eventLog *l = &g_log;
+    logRing  *ring = &l->rings[g_event_ring];
+    unsigned int head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    logRecord *r;
+
+    if (head - atomic_load_explicit(&ring->tail, memory_order_acquire) >= LOG_RING_SIZE)
+    {
+        atomic_fetch_add_explicit(&l->dropped, 1, memory_order_relaxed);
+        return;
+    }
+
+    r = &ring->records[head & (LOG_RING_SIZE - 1)];
+    r->code     = code;
+    r->detail   = detail;
+    r->deck     = g_event_deck;
+    r->position = position;
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
+//-----------------------------------------------------------------------------
+// Name: formatEvent()
+// Desc: Drainer Thread: One Line of Text for a Record
+//-----------------------------------------------------------------------------
+static void formatEvent(const logRecord *r, char *line, size_t size)
+{
+    double rate    = data.sfinfo1.samplerate > 0 ? data.sfinfo1.samplerate : SAMPLING_RATE;
+    double seconds = r->position / rate;
+    int    minutes = (int)(seconds / 60), prefix = 0;
+
+    /* Deck B's Events Say so, its Position is in its Own File */
+    if (r->deck)
+    {
+        prefix = snprintf(line, size, "Deck B ");
+        line  += prefix;
+        size  -= prefix;
+    }
+
+    seconds -= minutes * 60;
+    switch (r->code)
+    {
+        case LOG_SRC_ERROR:
+            snprintf(line, size, "%d:%06.3f Resampler Error, Silenced %d Frames: %s",
+                minutes, seconds, r->detail & 0xFFFF, src_strerror(r->detail >> 16));
+            break;
+        case LOG_CACHE_UNDERRUN:
+            snprintf(line, size, "%d:%06.3f Playback Cache Ran Dry, Silenced Part of %d Frames",
+                minutes, seconds, r->detail);
+            break;
+        case LOG_OUTPUT_UNDERFLOW:
+            snprintf(line, size, "%d:%06.3f Output Underflow Reported by PortAudio", minutes, seconds);
+            break;
+        case LOG_OUTPUT_OVERFLOW:
+            snprintf(line, size, "%d:%06.3f Output Overflow Reported by PortAudio", minutes, seconds);
+            break;
+        case LOG_SRC_DOWNGRADE:
+        case LOG_SRC_UPGRADE:
+            snprintf(line, size, "%d:%06.3f Resampler %s to %s, Callback p99 at %d%% of Deadline",
+                minutes, seconds, r->code == LOG_SRC_DOWNGRADE ? "Down" : "Up",
+                src_get_name(r->detail >> 8), r->detail & 0xFF);
+            break;
+        default:
+            snprintf(line, size, "%d:%06.3f Unknown Event %d (%d)", minutes, seconds, r->code, r->detail);
+            break;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name: drainEventLog()
+// Desc: Drainer Thread: Writes Every Queued Record and Any Drops to the File
+//       and Keeps the Latest Line for the ncurses Panel
+//-----------------------------------------------------------------------------
+static void drainEventLog(eventLog *l)
+{
+    unsigned int tail, head, dropped;
+    char line[sizeof(l->lastLine)], stamp[32];
+    time_t now = time(NULL);
+    logRing *ring;
+    int k;
+
+    strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", localtime(&now));
+    for (k = 0; k < LOG_PRODUCERS; k++)
+    {
+        ring = &l->rings[k];
+        tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+        head = atomic_load_explicit(&ring->head, memory_order_acquire);
+        for (; tail != head; tail++)
+        {
+            formatEvent(&ring->records[tail & (LOG_RING_SIZE - 1)], line, sizeof(line));
+            atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+
+            if (l->file != NULL) {
+                fprintf(l->file, "%s %s\n", stamp, line);
+            }
+            pthread_mutex_lock(&l->lock);
+            memcpy(l->lastLine, line, sizeof(line));
+            l->total++;
+            pthread_mutex_unlock(&l->lock);
+        }
+    }
+
+    if ((dropped = atomic_exchange_explicit(&l->dropped, 0, memory_order_relaxed)) > 0 && l->file != NULL) {
+        fprintf(l->file, "%s %u Events Dropped, Ring Full\n", stamp, dropped);
+    }
+    if (l->file != NULL) {
+        fflush(l->file);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name: eventLogMain()
+// Desc: Low-Priority Drainer, Wakes Every LOG_POLL_MS
+//-----------------------------------------------------------------------------
+static void* eventLogMain(void *arg)
+{
+    eventLog *l = (eventLog*)arg;
+
+    while (!atomic_load_explicit(&l->quit, memory_order_relaxed))
+    {
+        drainEventLog(l);
+        SLEEP( LOG_POLL_MS );
+    }
+    drainEventLog(l);
+    return NULL;
+}
+
+//-----------------------------------------------------------------------------
+// Name: initialize_eventLog(const char* path)
+// Desc: Opens the Log for Appending and Starts the Drainer. Without a File
+//       Events Still Reach the Panel.
+//-----------------------------------------------------------------------------
+void initialize_eventLog(const char* path)
+{
+    eventLog *l = &g_log;
+    time_t now = time(NULL);
+    char   stamp[32];
+    int    k;
+
+    for (k = 0; k < LOG_PRODUCERS; k++)
+    {
+        atomic_store(&l->rings[k].head, 0);
+        atomic_store(&l->rings[k].tail, 0);
+    }
+    atomic_store(&l->dropped, 0);
+    atomic_store(&l->quit, false);
+    pthread_mutex_init(&l->lock, NULL);
+    l->lastLine[0] = '\0';
+    l->total = 0;
+
+    if ((l->file = fopen(path, "a")) != NULL)
+    {
+        strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", localtime(&now));
+        fprintf(l->file, "%s Started on %s\n", stamp, g_options.inFile);
+        fflush(l->file);
+    }
+    else {
+        printf("Warning, Couldn't Open Log File %s: %s\n", path, strerror(errno));
+    }
+
+    l->running = pthread_create(&l->thread, NULL, eventLogMain, l) == 0;
+}
+
+//-----------------------------------------------------------------------------
+// Name: stop_eventLog()
+// Desc: Drains What is Left and Closes the File
+//-----------------------------------------------------------------------------
+void stop_eventLog()
+{
+    eventLog *l = &g_log;
+
+    if (l->running)
+    {
+        atomic_store(&l->quit, true);
+        pthread_join(l->thread, NULL);
+        l->running = false;
+    }
+    if (l->file != NULL)
+    {
+        fclose(l->file);
+        l->file = NULL;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name: printEventLog()
+// Desc: Latest Event on the Panel, Redrawn Only When a New One Arrives
+//-----------------------------------------------------------------------------
+void printEventLog()
+{
+    static unsigned int lastTotal = 0;
+    eventLog *l = &g_log;
+    char line[sizeof(l->lastLine)];
+    unsigned int total;
+
+    if (!l->running) {
+        return;
+    }
+
+    pthread_mutex_lock(&l->lock);
+    total = l->total;
+    memcpy(line, l->lastLine, sizeof(line));
+    pthread_mutex_unlock(&l->lock);
+
+    if (total == lastTotal) {
+        return;
+    }
+    lastTotal = total;
+
+    mvprintw(26,0,"Events: %u, Last %s\n", total, line);
+    refresh();
+}
+
+//-----------------------------------------------------------------------------
+// Parameter Automation
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Name: postControl(int control, double value) / nudgeControl(int control, double delta)
+// Desc: Control API for the UI Thread, the Only Producer. Sets a Control, or
+//       Moves it by delta Within its Range, at the Audio Thread's Next Block
+//       so Key Repeats Faster Than a Block Never Work From a Stale Value.
+//       Changes go to the Selected Deck.
+//-----------------------------------------------------------------------------
+static void queueControl(int control, double value, bool relative)
+{
+    automation *a = &data.automation;
+    unsigned int head = atomic_load_explicit(&a->incomingHead, memory_order_relaxed);
+    controlChange *c;
+
+    if (head - atomic_load_explicit(&a->incomingTail, memory_order_acquire) >= AUTOMATION_RING_SIZE) {
+        return;
+    }
+
+    c = &a->incoming[head & (AUTOMATION_RING_SIZE - 1)];
+    c->control  = control;
+    c->deck     = g_deck == &deckB;
+    c->value    = value;
+    c->relative = relative;
+    atomic_store_explicit(&a->incomingHead, head + 1, memory_order_release);
+}
+
+void postControl(int control, double value)
+{
+    queueControl(control, value, false);
+}
+
+void nudgeControl(int control, double delta)
+{
+    queueControl(control, delta, true);
+}
+
+//-----------------------------------------------------------------------------
+// Name: applyControl()
+// Desc: Audio Thread: Sets One Control and Hands the Absolute Value, Stamped
+//       With the Output Frame it Takes Effect on, to the Recorder
+//-----------------------------------------------------------------------------
+static void applyControl(paData *data, const controlChange *change, sf_count_t frame)
+{
+    automation *a = &data->automation;
+    paData *deck = change->deck ? &deckB : data;
+    double value = change->value;
+    unsigned int head;
+    controlChange *r;
+
+    /* A Script Written for Two Decks, Played With One */
+    if (deck->inFile == NULL) {
+        return;
+    }
+
+    /* Nudges Land on Whatever the Control Holds Now */
+    if (change->relative)
+    {
+        switch (change->control)
+        {
+            case AUTO_RATIO:      value += deck->src_ratio;   break;
+            case AUTO_LPF_FREQ:   value += deck->lpf_freq;    break;
+            case AUTO_LPF_RES:    value += deck->lpf_res;     break;
+            case AUTO_HPF_FREQ:   value += deck->hpf_freq;    break;
+            case AUTO_HPF_RES:    value += deck->hpf_res;     break;
+            case AUTO_VOLUME:     value += deck->amplitude;   break;
+            case AUTO_CROSSFADER: value += data->crossfader;  break;
+            default:
+                return;
+        }
+    }
+
+    /* Whatever Sent it, a Value Outside the Keys' Range Never Reaches the Deck */
+    if (change->control < 0 || change->control >= AUTO_CONTROLS) {
+        return;
+    }
+    value = fmin(fmax(value, automationLimits[change->control][0]), automationLimits[change->control][1]);
+    if (change->control == AUTO_DIRECTION) {
+        value = value < 0 ? -1 : 1;
+    }
+
+    switch (change->control)
+    {
+        case AUTO_RATIO:         deck->src_ratio = value;                break;
+        case AUTO_DIRECTION:     deck->direction = (int)value;           break;
+        case AUTO_MOTOR:         deck->motor     = (int)value;           break;
+        case AUTO_LPF_ON:        deck->lpf_On    = value != 0;           break;
+        case AUTO_LPF_FREQ:      deck->lpf_freq  = (int)value;           break;
+        case AUTO_LPF_RES:       deck->lpf_res   = (int)value;           break;
+        case AUTO_HPF_ON:        deck->hpf_On    = value != 0;           break;
+        case AUTO_HPF_FREQ:      deck->hpf_freq  = (int)value;           break;
+        case AUTO_HPF_RES:       deck->hpf_res   = (int)value;           break;
+        case AUTO_VOLUME:        deck->amplitude = (float)value;         break;
+        case AUTO_CROSSFADER:    data->crossfader = value;               break;
+        case AUTO_SCRATCH:
+            atomic_store_explicit(&deck->scratching, value != 0, memory_order_relaxed);
+            break;
+        case AUTO_SCRATCH_SPEED:
+            atomic_store_explicit(&deck->scratchSpeed, value, memory_order_relaxed);
+            break;
+        case AUTO_SEEK:
+            requestSeek(deck, (sf_count_t)value);
+            break;
+        default:
+            return;
+    }
+    atomic_fetch_add_explicit(&a->sequence, 1, memory_order_release);
+
+    if (!a->recording) {
+        return;
+    }
+    head = atomic_load_explicit(&a->appliedHead, memory_order_relaxed);
+    if (head - atomic_load_explicit(&a->appliedTail, memory_order_acquire) >= AUTOMATION_RING_SIZE)
+    {
+        atomic_fetch_add_explicit(&a->dropped, 1, memory_order_relaxed);
+        return;
+    }
+    r = &a->applied[head & (AUTOMATION_RING_SIZE - 1)];
+    r->frame    = frame;
+    r->control  = change->control;
+    r->deck     = change->control == AUTO_CROSSFADER ? 0 : change->deck;
+    r->value    = value;
+    r->relative = false;
+    atomic_store_explicit(&a->appliedHead, head + 1, memory_order_release);
+}
+
+//-----------------------------------------------------------------------------
+// Name: automationProcess( )
+// Desc: Wraps processAudio() for the Callback and the Exporter. Live Changes
+//       Apply at the Top of the Block. A Script's Changes Apply on Their Exact
+//       Frame, the Block Rendered in Pieces Between Them. Live Changes are
+//       Ignored Until the Script Runs Out.
+//-----------------------------------------------------------------------------
+void automationProcess(paData *data, float *out, unsigned long framesPerBuffer)
+{
+    automation *a = &data->automation;
+    unsigned int head, tail;
+    unsigned long done, n;
+    sf_count_t now;
+
+    head = atomic_load_explicit(&a->incomingHead, memory_order_acquire);
+    for (tail = atomic_load_explicit(&a->incomingTail, memory_order_relaxed); tail != head; tail++)
+    {
+        if (a->scriptNext >= a->scriptLength) {
+            applyControl(data, &a->incoming[tail & (AUTOMATION_RING_SIZE - 1)], a->frame);
+        }
+    }
+    atomic_store_explicit(&a->incomingTail, tail, memory_order_release);
+
+    for (done = 0; done < framesPerBuffer; done += n)
+    {
+        now = a->frame + done;
+        while (a->scriptNext < a->scriptLength && a->script[a->scriptNext].frame <= now)
+        {
+            applyControl(data, &a->script[a->scriptNext], now);
+            a->scriptNext++;
+            atomic_store_explicit(&a->played, a->scriptNext, memory_order_relaxed);
+        }
+
+        n = framesPerBuffer - done;
+        if (a->scriptNext < a->scriptLength && a->script[a->scriptNext].frame < now + (sf_count_t)n) {
+            n = (unsigned long)(a->script[a->scriptNext].frame - now);
+        }
+        processAudio(data, out + done * data->sfinfo1.channels, n);
+    }
+    a->frame += framesPerBuffer;
+}
+
+//-----------------------------------------------------------------------------
+// Name: automationValueValid(int control, double value)
+// Desc: A Script Value Within automationLimits, Switches and the Motor Whole
+//       Numbers, Direction Exactly -1 or 1. NaN Fails Every Comparison.
+//-----------------------------------------------------------------------------
+static bool automationValueValid(int control, double value)
+{
+    if (!(value >= automationLimits[control][0] && value <= automationLimits[control][1])) {
+        return false;
+    }
+    switch (control)
+    {
+        case AUTO_DIRECTION:
+            return value != 0 && value == floor(value);
+        case AUTO_MOTOR:
+        case AUTO_LPF_ON:
+        case AUTO_HPF_ON:
+        case AUTO_SCRATCH:
+            return value == floor(value);
+        default:
+            return true;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name: initialize_automation()
+// Desc: Loads a Script to Play and/or Opens a File to Record To. Script Lines
+//       are "frame control value", Frames Counted in Output Frames From the
+//       Start of Playback, in Order. Controls Prefixed "b." Work Deck B.
+//       '#' Starts a Comment.
+//-----------------------------------------------------------------------------
+bool initialize_automation(automation *a, const char* recordPath, const char* playPath)
+{
+    FILE   *fp;
+    char    line[256], name[32], *controlName;
+    controlChange *script;
+    long long frame, last = 0;
+    double  value;
+    int     control, deck, lineNumber = 0, capacity = 0;
+
+    memset(a, 0, sizeof(*a));
+
+    if (playPath != NULL)
+    {
+        if ((fp = fopen(playPath, "r")) == NULL)
+        {
+            printf("Error, Couldn't Open %s\n", playPath);
+            return false;
+        }
+        while (fgets(line, sizeof(line), fp) != NULL)
+        {
+            lineNumber++;
+            if (sscanf(line, " %31s", name) != 1 || name[0] == '#') {
+                continue;
+            }
+            if (sscanf(line, "%lld %31s %lf", &frame, name, &value) != 3 || frame < last)
+            {
+                printf("Error, %s Line %d: Expected \"frame control value\" With Frames in Order\n", playPath, lineNumber);
+                fclose(fp);
+                return false;
+            }
+            deck = strncmp(name, "b.", 2) == 0;
+            controlName = name + 2 * deck;
+            for (control = 0; control < AUTO_CONTROLS && strcmp(controlName, automationNames[control]) != 0; control++) {
+            }
+            /* One Crossfader Between the Decks, Not One per Deck */
+            if (control == AUTO_CONTROLS || (deck && control == AUTO_CROSSFADER))
+            {
+                printf("Error, %s Line %d: Unknown Control %s\n", playPath, lineNumber, name);
+                fclose(fp);
+                return false;
+            }
+            if (!automationValueValid(control, value))
+            {
+                printf("Error, %s Line %d: Bad Value %g for %s, Range is %g to %g\n", playPath, lineNumber,
+                    value, name, automationLimits[control][0], automationLimits[control][1]);
+                fclose(fp);
+                return false;
+            }
+
+            if (a->scriptLength == capacity)
+            {
+                capacity = capacity ? capacity * 2 : 256;
+                if ((script = realloc(a->script, capacity * sizeof(controlChange))) == NULL)
+                {
+                    printf("Error, Out of Memory Loading %s\n", playPath);
+                    fclose(fp);
+                    return false;
+                }
+                a->script = script;
+            }
+            a->script[a->scriptLength].frame    = frame;
+            a->script[a->scriptLength].control  = control;
+            a->script[a->scriptLength].deck     = deck;
+            a->script[a->scriptLength].value    = value;
+            a->script[a->scriptLength].relative = false;
+            a->scriptLength++;
+            last = frame;
+        }
+        fclose(fp);
+        printf("Automation: Playing %d Changes From %s\n", a->scriptLength, playPath);
+    }
+
+    if (recordPath != NULL)
+    {
+        if ((a->recordFile = fopen(recordPath, "w")) == NULL)
+        {
+            printf("Error, Couldn't Create %s\n", recordPath);
+            return false;
+        }
+        fprintf(a->recordFile, "# VinylVisualizer Automation: Output Frame, Control, Value\n");
+        a->recording = true;
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// Name: drainAutomation()
+// Desc: Control Side: Appends Every Applied Change to the Recording
+//-----------------------------------------------------------------------------
+void drainAutomation(automation *a)
+{
+    unsigned int head, tail, dropped;
+    controlChange *c;
+
+    if (a->recordFile == NULL) {
+        return;
+    }
+
+    head = atomic_load_explicit(&a->appliedHead, memory_order_acquire);
+    for (tail = atomic_load_explicit(&a->appliedTail, memory_order_relaxed); tail != head; tail++)
+    {
+        c = &a->applied[tail & (AUTOMATION_RING_SIZE - 1)];
+        fprintf(a->recordFile, "%lld %s%s %.17g\n", (long long)c->frame, c->deck ? "b." : "",
+                automationNames[c->control], c->value);
+    }
+    atomic_store_explicit(&a->appliedTail, tail, memory_order_release);
+
+    if ((dropped = atomic_exchange_explicit(&a->dropped, 0, memory_order_relaxed)) > 0) {
+        fprintf(a->recordFile, "# %u Changes Dropped, Ring Full\n", dropped);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name: stop_automation()
+// Desc: Writes Out the Last Changes and Closes the Recording
+//-----------------------------------------------------------------------------
+void stop_automation(automation *a)
+{
+    drainAutomation(a);
+    if (a->recordFile != NULL)
+    {
+        fclose(a->recordFile);
+        a->recordFile = NULL;
+    }
+    a->recording = false;
+    free(a->script);
+    a->script = NULL;
+    a->scriptLength = a->scriptNext = 0;
+}
+
+//-----------------------------------------------------------------------------
+// Name: printAutomationStatus()
+// Desc: Recording or Playing Progress, and a Panel Refresh Whenever the Audio
+//       Thread Applied a Change, Keyed or Scripted
+//-----------------------------------------------------------------------------
+void printAutomationStatus()
+{
+    static unsigned int lastSequence = 0;
+    automation *a = &data.automation;
+    unsigned int sequence = atomic_load_explicit(&a->sequence, memory_order_acquire);
+
+    if (sequence == lastSequence) {
+        return;
+    }
+    lastSequence = sequence;
+
+    if (a->scriptLength > 0) {
+        mvprintw(28,0,"Automation: Playing, %d of %d Changes\n",
+            atomic_load_explicit(&a->played, memory_order_relaxed), a->scriptLength);
+    }
+    else if (a->recording) {
+        mvprintw(28,0,"Automation: Recording, %u Changes\n", atomic_load_explicit(&a->appliedHead, memory_order_relaxed));
+    }
+    printGUI();
+}
+
+//-----------------------------------------------------------------------------
+// Second Deck
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Name: deckWorkerRun()
+// Desc: Plays One Posted Block on the Worker's Deck, on Whichever Thread
+//       Claimed it
+//-----------------------------------------------------------------------------
+static void deckWorkerRun(deckWorker *w, unsigned int block)
+{
+    g_event_deck = 1;
+    deckProcess(w->deck, w->frames);
+    deckVisualsWrite(w->deck, w->frames);
+    g_event_deck = 0;
+    atomic_store_explicit(&w->finished, block, memory_order_release);
+}
+
+//-----------------------------------------------------------------------------
+// Name: deckWorkerMain()
+// Desc: Claims Each Block as Soon as it is Posted, Sleeping in Between. Its
+//       Events go on Their Own Ring so the Log Keeps One Producer per Ring.
+//-----------------------------------------------------------------------------
+static void* deckWorkerMain(void *arg)
+{
+    deckWorker *w = (deckWorker*)arg;
+    unsigned int block;
+    struct timespec until;
+
+    g_event_ring = 1;
+    while (!atomic_load_explicit(&w->quit, memory_order_relaxed))
+    {
+        block = atomic_load_explicit(&w->claimed, memory_order_relaxed);
+        if (atomic_load_explicit(&w->posted, memory_order_acquire) != block &&
+            atomic_compare_exchange_strong(&w->claimed, &block, block + 1))
+        {
+            deckWorkerRun(w, block + 1);
+            continue;
+        }
+
+        /* Nothing Posted, Sleep Until the Callback Signals or the Timeout */
+        pthread_mutex_lock(&w->lock);
+        if (atomic_load_explicit(&w->posted, memory_order_acquire) == atomic_load(&w->claimed) &&
+            !atomic_load_explicit(&w->quit, memory_order_relaxed))
+        {
+            clock_gettime(CLOCK_REALTIME, &until);
+            until.tv_nsec += DECK_WAIT_MS * 1000000L;
+            if (until.tv_nsec >= 1000000000L)
+            {
+                until.tv_sec++;
+                until.tv_nsec -= 1000000000L;
+            }
+            pthread_cond_timedwait(&w->wake, &w->lock, &until);
+        }
+        pthread_mutex_unlock(&w->lock);
+    }
+    return NULL;
+}
+
+//-----------------------------------------------------------------------------
+// Name: initialize_deckWorker()
+// Desc: Starts the Worker for w->deck at the Audio Thread's Priority and Pinning
+//-----------------------------------------------------------------------------
+void initialize_deckWorker(deckWorker *w)
+{
+    struct sched_param param;
+
+    atomic_store(&w->quit, false);
+    atomic_store(&w->posted, 0);
+    atomic_store(&w->claimed, 0);
+    atomic_store(&w->finished, 0);
+    pthread_mutex_init(&w->lock, NULL);
+    pthread_cond_init(&w->wake, NULL);
+
+    if (!(w->running = pthread_create(&w->thread, NULL, deckWorkerMain, w) == 0))
+    {
+        reportRealtime("Deck B Worker Not Started, the Audio Thread Plays Both Decks");
+        return;
+    }
+    if (g_options.rt_policy != SCHED_OTHER)
+    {
+        memset(&param, 0, sizeof(param));
+        param.sched_priority = g_options.rt_priority;
+        pthread_setschedparam(w->thread, g_options.rt_policy, &param);
+    }
+    pinThread(w->thread, RT_THREAD_AUDIO);
+}
+
+//-----------------------------------------------------------------------------
+// Name: deckWorkerPost()
+// Desc: Audio Thread: Hands the Worker the Next Block and Wakes it, Unless
+//       That Would Mean Waiting on its Lock
+//-----------------------------------------------------------------------------
+void deckWorkerPost(deckWorker *w, unsigned long framesPerBuffer)
+{
+    w->frames = framesPerBuffer;
+    atomic_fetch_add_explicit(&w->posted, 1, memory_order_release);
+
+    if (w->running && pthread_mutex_trylock(&w->lock) == 0)
+    {
+        pthread_cond_signal(&w->wake);
+        pthread_mutex_unlock(&w->lock);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name: deckWorkerWait()
+// Desc: Audio Thread: The Per-Block Barrier. A Block the Worker Never Woke
+//       up for is Played Right Here Instead, so the Callback Only Ever
+//       Waits on a Worker That is Already Running it.
+//-----------------------------------------------------------------------------
+void deckWorkerWait(deckWorker *w)
+{
+    unsigned int block = atomic_load_explicit(&w->posted, memory_order_relaxed), claimed = block - 1;
+
+    if (atomic_compare_exchange_strong(&w->claimed, &claimed, block))
+    {
+        deckWorkerRun(w, block);
+        return;
+    }
+
+    /* Yielding Lets a Worker Pinned to This Core at This Priority Finish */
+    while (atomic_load_explicit(&w->finished, memory_order_acquire) != block) {
+        sched_yield();
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name: stop_deckWorker()
+// Desc: Joins the Worker, Whatever Block it Was on is Finished First
+//-----------------------------------------------------------------------------
+void stop_deckWorker(deckWorker *w)
+{
+    if (!w->running) {
+        return;
+    }
+    atomic_store(&w->quit, true);
+    pthread_mutex_lock(&w->lock);
+    pthread_cond_signal(&w->wake);
+    pthread_mutex_unlock(&w->lock);
+    pthread_join(w->thread, NULL);
+    w->running = false;
+}
+
+//-----------------------------------------------------------------------------
+// Name: readDeckRings()
+// Desc: Each Deck's Channel Mean, Deck A Into outer and Deck B Into inner
+//-----------------------------------------------------------------------------
+void readDeckRings(float *outer, float *inner, int numFrames)
+{
+    float other[numFrames];
+
+    channelHistoryRead(&deckB.history, other, inner, numFrames);
+    splitRingChannels(RING_MODE_MIX, other, inner, numFrames, inner, inner);
+    channelHistoryRead(&data.history, outer, other, numFrames);
+    splitRingChannels(RING_MODE_MIX, outer, other, numFrames, outer, outer);
+}
+
+//-----------------------------------------------------------------------------
+// Waveform Overview
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Name: pyramidLayout()
+// Desc: Fills the Level Table for a Track and Returns the Total Byte Size of
+//       Header Plus Levels. Level k Holds ceil(frames / 2^(base + k)) Bins of
+//       min, max and RMS per Channel, Halving Until a Single Bin is Left.
+//-----------------------------------------------------------------------------
+static size_t pyramidLayout(pyramidHeader *h)
+{
+    int64_t bins = (h->frames + (1LL << h->baseShift) - 1) >> h->baseShift;
+    int64_t offset = sizeof(pyramidHeader);
+    int     k;
+
+    if (bins < 1) {
+        bins = 1;
+    }
+    for (k = 0; k < PYRAMID_MAX_LEVELS; k++)
+    {
+        h->levelBins[k]   = bins;
+        h->levelOffset[k] = offset;
+        offset += bins * h->numChannels * 3 * sizeof(int16_t);
+        offset  = (offset + 7) & ~7LL;
+        if (bins == 1) {
+            break;
+        }
+        bins = (bins + 1) / 2;
+    }
+    h->numLevels = k + 1;
+    return (size_t)offset;
+}
+
+//-----------------------------------------------------------------------------
+// Name: pyramidQuantize(float x)
+// Desc: Full Scale to int16, Clamped
+//-----------------------------------------------------------------------------
+static int16_t pyramidQuantize(float x)
+{
+    if (x > 1.0f) {
+        x = 1.0f;
+    }
+    if (x < -1.0f) {
+        x = -1.0f;
+    }
+    return (int16_t)lrintf(x * 32767.0f);
+}
+
+//-----------------------------------------------------------------------------
+// Name: mapOverviewSidecar()
+// Desc: Memory-Maps a Sidecar That Still Matches the Audio File's Size,
+//       Modification Time and Format. Returns false When There is None or it
+//       is Stale. The Layout is Rebuilt From the Source, Never Trusted From
+//       the File, so a Damaged Sidecar Can't Point Outside the Mapping.
+//-----------------------------------------------------------------------------
+static bool mapOverviewSidecar(waveformOverview *o, const struct stat *source, const SF_INFO *info)
+{
+    pyramidHeader *h, expected;
+    struct stat st;
+    void *mapping;
+    int fd, k;
+
+    if ((fd = open(o->sidecarPath, O_RDONLY)) < 0) {
+        return false;
+    }
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(pyramidHeader))
+    {
+        close(fd);
+        return false;
+    }
+    mapping = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+
+    /* Header Must Describe This Exact Source and Fit the Mapping */
+    h = (pyramidHeader*)mapping;
+    memset(&expected, 0, sizeof(expected));
+    expected.frames      = info->frames;
+    expected.numChannels = info->channels;
+    expected.baseShift   = PYRAMID_BASE_SHIFT;
+    if (memcmp(h->magic, PYRAMID_MAGIC, sizeof(h->magic)) != 0 ||
+        h->sourceSize != (int64_t)source->st_size || h->sourceMtime != (int64_t)source->st_mtime ||
+        h->frames != expected.frames || h->sampleRate != info->samplerate ||
+        h->numChannels != expected.numChannels || h->baseShift != expected.baseShift ||
+        pyramidLayout(&expected) != (size_t)st.st_size || expected.numLevels != h->numLevels ||
+        memcmp(h->levelBins, expected.levelBins, sizeof(expected.levelBins)) != 0 ||
+        memcmp(h->levelOffset, expected.levelOffset, sizeof(expected.levelOffset)) != 0)
+    {
+        munmap(mapping, st.st_size);
+        return false;
+    }
+
+    o->mapping     = mapping;
+    o->mappingSize = st.st_size;
+    o->header      = h;
+    for (k = 0; k < expected.numLevels; k++) {
+        o->levels[k] = (const int16_t*)((const char*)mapping + expected.levelOffset[k]);
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// Name: overviewBuilderMain()
+// Desc: One Streaming Pass Over Its Own Handle of the File Fills the Base
+//       Level, Each Level Above is Then Folded From the One Below. Published
+//       With a Release Store so the Render Thread Sees Finished Levels Only.
+//-----------------------------------------------------------------------------
+static void* overviewBuilderMain(void *arg)
+{
+    waveformOverview *o = (waveformOverview*)arg;
+    pyramidHeader *h = (pyramidHeader*)o->storage;
+    static float block[PYRAMID_READ_FRAMES * STEREO];
+    float   lo[STEREO], hi[STEREO], x;
+    double  sumSquares[STEREO], start = getTimeSeconds();
+    int16_t *bin, *child;
+    int64_t b, count = 0, binFrames = 1LL << h->baseShift;
+    sf_count_t got, i;
+    int     ch, k, c, numChannels = h->numChannels;
+    SNDFILE* fp;
+    SF_INFO info;
+    FILE*   out;
+    char    tmpPath[sizeof(o->sidecarPath) + 8];
+
+    memset(&info, 0, sizeof(info));
+    if ((fp = sf_open(o->sourcePath, SFM_READ, &info)) == NULL)
+    {
+        atomic_store_explicit(&o->state, OVERVIEW_FAILED, memory_order_release);
+        return NULL;
+    }
+
+    /* Base Level */
+    bin = (int16_t*)((char*)o->storage + h->levelOffset[0]);
+    for (ch = 0; ch < numChannels; ch++)
+    {
+        lo[ch] = hi[ch] = 0;
+        sumSquares[ch] = 0;
+    }
+    while ((got = sf_readf_float(fp, block, PYRAMID_READ_FRAMES)) > 0)
+    {
+        for (i = 0; i < got; i++)
+        {
+            for (ch = 0; ch < numChannels; ch++)
+            {
+                x = block[i * numChannels + ch];
+                if (count == 0) {
+                    lo[ch] = hi[ch] = x;
+                }
+                else if (x < lo[ch]) {
+                    lo[ch] = x;
+                }
+                else if (x > hi[ch]) {
+                    hi[ch] = x;
+                }
+                sumSquares[ch] += x * x;
+            }
+            if (++count == binFrames)
+            {
+                for (ch = 0; ch < numChannels; ch++, bin += 3)
+                {
+                    bin[0] = pyramidQuantize(lo[ch]);
+                    bin[1] = pyramidQuantize(hi[ch]);
+                    bin[2] = pyramidQuantize((float)sqrt(sumSquares[ch] / count));
+                    sumSquares[ch] = 0;
+                }
+                count = 0;
+            }
+        }
+    }
+    sf_close(fp);
+
+    /* Partial Last Bin */
+    if (count > 0)
+    {
+        for (ch = 0; ch < numChannels; ch++, bin += 3)
+        {
+            bin[0] = pyramidQuantize(lo[ch]);
+            bin[1] = pyramidQuantize(hi[ch]);
+            bin[2] = pyramidQuantize((float)sqrt(sumSquares[ch] / count));
+        }
+    }
+
+    /* Fold Pairs of Bins Into the Next Level */
+    for (k = 1; k < h->numLevels; k++)
+    {
+        child = (int16_t*)((char*)o->storage + h->levelOffset[k - 1]);
+        bin   = (int16_t*)((char*)o->storage + h->levelOffset[k]);
+        for (b = 0; b < h->levelBins[k]; b++)
+        {
+            for (ch = 0; ch < numChannels; ch++, bin += 3)
+            {
+                int16_t *a = child + (2 * b * numChannels + ch) * 3;
+                int16_t *z = 2 * b + 1 < h->levelBins[k - 1] ? a + numChannels * 3 : a;
+
+                bin[0] = a[0] < z[0] ? a[0] : z[0];
+                bin[1] = a[1] > z[1] ? a[1] : z[1];
+                bin[2] = (int16_t)lrint(sqrt(0.5 * ((double)a[2] * a[2] + (double)z[2] * z[2])));
+            }
+        }
+    }
+    for (k = 0; k < h->numLevels; k++) {
+        o->levels[k] = (const int16_t*)((const char*)o->storage + h->levelOffset[k]);
+    }
+    o->header    = h;
+    o->buildTime = getTimeSeconds() - start;
+
+    /* Persist Through a Temporary Name so a Crash Never Leaves a Torn Sidecar */
+    snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", o->sidecarPath);
+    if ((out = fopen(tmpPath, "wb")) != NULL)
+    {
+        c  = fwrite(o->storage, o->storageSize, 1, out) == 1;
+        c &= fclose(out) == 0;
+        o->saved = c && rename(tmpPath, o->sidecarPath) == 0;
+        if (!o->saved) {
+            unlink(tmpPath);
+        }
+    }
+
+    atomic_store_explicit(&o->state, OVERVIEW_READY, memory_order_release);
+    return NULL;
+}
+
+//-----------------------------------------------------------------------------
+// Name: initialize_overview(const char* inFile)
+// Desc: Maps the Track's Sidecar When it is Current, Otherwise Starts a
+//       Worker to Build (and Save) the Pyramid While Playback Runs
+//-----------------------------------------------------------------------------
+void initialize_overview(const char* inFile)
+{
+    waveformOverview *o = &g_overview;
+    pyramidHeader *h;
+    struct stat source;
+    pthread_t thread;
+
+    o->sourcePath = inFile;
+    snprintf(o->sidecarPath, sizeof(o->sidecarPath), "%s%s", inFile, PYRAMID_EXTENSION);
+    atomic_store(&o->state, OVERVIEW_FAILED);
+
+    if (stat(inFile, &source) != 0 || data.sfinfo1.frames <= 0) {
+        return;
+    }
+
+    /* Later Opens: Instant */
+    if (mapOverviewSidecar(o, &source, &data.sfinfo1))
+    {
+        atomic_store_explicit(&o->state, OVERVIEW_READY, memory_order_release);
+        return;
+    }
+
+    /* First Open: Lay Out the Sidecar Image in Memory, Build it in the Background */
+    if ((h = calloc(1, sizeof(pyramidHeader))) == NULL) {
+        return;
+    }
+    memcpy(h->magic, PYRAMID_MAGIC, sizeof(h->magic));
+    h->sourceSize  = source.st_size;
+    h->sourceMtime = source.st_mtime;
+    h->sampleRate  = data.sfinfo1.samplerate;
+    h->numChannels = data.sfinfo1.channels;
+    h->frames      = data.sfinfo1.frames;
+    h->baseShift   = PYRAMID_BASE_SHIFT;
+    o->storageSize = pyramidLayout(h);
+
+    /* Hours of Audio Make a Large Image, Play on Without the Overview */
+    if ((o->storage = calloc(1, o->storageSize)) == NULL)
+    {
+        free(h);
+        return;
+    }
+    memcpy(o->storage, h, sizeof(pyramidHeader));
+    free(h);
+
+    atomic_store(&o->state, OVERVIEW_BUILDING);
+    if (pthread_create(&thread, NULL, overviewBuilderMain, o) != 0)
+    {
+        atomic_store(&o->state, OVERVIEW_FAILED);
+        return;
+    }
+    pthread_detach(thread);
+}
+
+//-----------------------------------------------------------------------------
+// Name: updateOverviewGeometry()
+// Desc: One Vertical min/max Line and One RMS Line per Pixel Column, From the
+//       Coarsest Level That Still Has a Bin for Every Column. Only Rebuilt
+//       When the Window Size Changes, the Pyramid Never Does. Returns false,
+//       and Gives up on the Overview, if the Vertices Don't Fit in Memory.
+//-----------------------------------------------------------------------------
+static bool updateOverviewGeometry(waveformOverview *o, int width, int height)
+{
+    const pyramidHeader *h = o->header;
+    const int16_t *level, *bin;
+    GLfloat *v;
+    float   base = height * OVERVIEW_MARGIN, half = height * OVERVIEW_HEIGHT * 0.5f, mid = base + half;
+    float   lo, hi, rms, scale = 1.0f / 32767.0f;
+    int64_t first, last, b, bins;
+    int     k = 0, x, ch, numChannels = h->numChannels;
+
+    while (k + 1 < h->numLevels && h->levelBins[k + 1] >= width) {
+        k++;
+    }
+    level = o->levels[k];
+    bins  = h->levelBins[k];
+
+    if ((v = malloc(width * 4 * 6 * sizeof(GLfloat))) == NULL)
+    {
+        atomic_store_explicit(&o->state, OVERVIEW_FAILED, memory_order_release);
+        return false;
+    }
+    for (x = 0; x < width; x++)
+    {
+        first = (int64_t)x * bins / width;
+        last  = (int64_t)(x + 1) * bins / width;
+        if (last <= first) {
+            last = first + 1;
+        }
+
+        lo = 1.0f; hi = -1.0f; rms = 0;
+        for (b = first; b < last; b++)
+        {
+            for (ch = 0; ch < numChannels; ch++)
+            {
+                bin = level + (b * numChannels + ch) * 3;
+                lo  = fminf(lo, bin[0] * scale);
+                hi  = fmaxf(hi, bin[1] * scale);
+                rms = fmaxf(rms, bin[2] * scale);
+            }
+        }
+
+        /* Envelope, Then the Brighter RMS Core */
+        GLfloat column[4][6] = {
+            { x + 0.5f, mid + lo * half,  0.35f, 0.35f, 0.45f, 1 },
+            { x + 0.5f, mid + hi * half,  0.35f, 0.35f, 0.45f, 1 },
+            { x + 0.5f, mid - rms * half, 0.9f,  0.5f,  0.7f,  1 },
+            { x + 0.5f, mid + rms * half, 0.9f,  0.5f,  0.7f,  1 },
+        };
+        memcpy(v + x * 24, column, sizeof(column));
+    }
+
+    if (o->vbo == 0) {
+        glGenBuffers( 1, &o->vbo );
+    }
+    glBindBuffer( GL_ARRAY_BUFFER, o->vbo );
+    glBufferData( GL_ARRAY_BUFFER, width * 4 * 6 * sizeof(GLfloat), v, GL_STATIC_DRAW );
+    glBindBuffer( GL_ARRAY_BUFFER, 0 );
+    free(v);
+
+    o->vboWidth  = width;
+    o->vboHeight = height;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// Name: drawOverview()
+// Desc: Whole-Track Strip Along the Bottom of the Window With the Playhead
+//-----------------------------------------------------------------------------
+void drawOverview()
+{
+    waveformOverview *o = &g_overview;
+    float x, top;
+
+    if (!o->visible || atomic_load_explicit(&o->state, memory_order_acquire) != OVERVIEW_READY) {
+        return;
+    }
+    if ((o->vboWidth != g_width || o->vboHeight != g_height) && !updateOverviewGeometry(o, g_width, g_height)) {
+        return;
+    }
+
+    /* Pixel Space, No Lighting or Depth */
+    glMatrixMode( GL_PROJECTION );
+    glPushMatrix();
+    glLoadIdentity();
+    gluOrtho2D( 0, g_width, 0, g_height );
+    glMatrixMode( GL_MODELVIEW );
+    glPushMatrix();
+    glLoadIdentity();
+    glPushAttrib( GL_ENABLE_BIT | GL_LINE_BIT );
+    glDisable( GL_LIGHTING );
+    glDisable( GL_DEPTH_TEST );
+    glLineWidth( 1.0f );
+
+    glBindBuffer( GL_ARRAY_BUFFER, o->vbo );
+    glEnableClientState( GL_VERTEX_ARRAY );
+    glEnableClientState( GL_COLOR_ARRAY );
+    glVertexPointer( 2, GL_FLOAT, 6 * sizeof(GLfloat), (const GLvoid*)0 );
+    glColorPointer( 4, GL_FLOAT, 6 * sizeof(GLfloat), (const GLvoid*)(2 * sizeof(GLfloat)) );
+    glDrawArrays( GL_LINES, 0, o->vboWidth * 4 );
+    glDisableClientState( GL_COLOR_ARRAY );
+    glDisableClientState( GL_VERTEX_ARRAY );
+    glBindBuffer( GL_ARRAY_BUFFER, 0 );
+
+    /* Playhead */
+    x   = (float)((double)atomic_load_explicit(&data.playhead, memory_order_relaxed) /
+                  o->header->frames * g_width);
+    top = g_height * (OVERVIEW_MARGIN + OVERVIEW_HEIGHT);
+    glColor3f( 1.0f, 1.0f, 1.0f );
+    glBegin( GL_LINES );
+    glVertex2f( x, g_height * OVERVIEW_MARGIN );
+    glVertex2f( x, top );
+    glEnd();
+
+    glPopAttrib();
+    glPopMatrix();
+    glMatrixMode( GL_PROJECTION );
+    glPopMatrix();
+    glMatrixMode( GL_MODELVIEW );
+}
+
+//-----------------------------------------------------------------------------
+// Name: printOverviewStatus()
+// Desc: Says Where the Overview Came From, Redrawn Only When That Changes
+//-----------------------------------------------------------------------------
+void printOverviewStatus()
+{
+    static int lastState = -1;
+    waveformOverview *o = &g_overview;
+    int state = atomic_load_explicit(&o->state, memory_order_acquire);
+
+    if (state == lastState) {
+        return;
+    }
+    lastState = state;
+
+    switch (state)
+    {
+        case OVERVIEW_BUILDING:
+            mvprintw(24,0,"Overview: Building\n");
+            break;
+        case OVERVIEW_READY:
+            if (o->mapping != NULL) {
+                mvprintw(24,0,"Overview: Mapped %s (%.1f MB)\n", o->sidecarPath, o->mappingSize / 1048576.0);
+            }
+            else {
+                mvprintw(24,0,"Overview: Built in %.2fs, %s\n", o->buildTime,
+                    o->saved ? "Saved Sidecar" : "Sidecar Not Writable");
+            }
+            break;
+        default:
+            mvprintw(24,0,"Overview: Unavailable\n");
+            break;
+    }
+    refresh();
+}
+
+//-----------------------------------------------------------------------------
+// Offscreen Export
+//-----------------------------------------------------------------------------
+
+/* One Batch of Video Frames, Rendered by Every Worker */
+typedef struct {
+    const char* outDir;
+    int    width, height;
+    bool   png;
+    int    numVertices;                         // Ring Level of Detail at This Height
+    int    firstFrame;                          // Frame Number of snapshots[0]
+    int    numFrames;
+    int    ringMode;
+    float  snapshots[EXPORT_BATCH_FRAMES][STEREO][FRAMES_PER_BUFFER];  // Left, Right
+    float  levels[EXPORT_BATCH_FRAMES];         // Envelope RMS at Each Snapshot
+    atomic_int next;                            // Next Frame in the Batch to Claim
+} exportBatch;
+
+/* Per-Thread Scratch, Reused for Every Frame That Thread Claims */
+typedef struct {
+    exportBatch*   batch;
+    unsigned char* pixels;                      // RGBA
+    unsigned char* scanlines;                   // PNG Filter Byte + Row, Per Row
+    unsigned char* compressed;
+    uLongf         compressedCapacity;
+    float          positions[2][FRAMES_PER_BUFFER * 3];  // Outer, Inner
+    float          colors[2][FRAMES_PER_BUFFER * 4];
+    float          outer[FRAMES_PER_BUFFER];
+    float          inner[FRAMES_PER_BUFFER];
+    float          envelope[FRAMES_PER_BUFFER];   // min/max Pairs When Decimating
+    int            failed;
+} exportWorker;
+
+//-----------------------------------------------------------------------------
+// Name: rasterizeRing()
+// Desc: Draws a Line Loop With the Same Projection as reshapeFunc Sets Up,
+//       Two Pixels Wide Like g_linewidth, Colors Interpolated and Clamped
+//-----------------------------------------------------------------------------
+static void rasterizeRing(unsigned char *pixels, int width, int height,
+                          const float *positions, const float *colors, int num_segments, float scale)
+{
+    float focal = (height * 0.5f) / tanf(CAMERA_FOVY * 0.5f * PI / 180.0f);
+    float x0, y0, x1, y1, t, px, py, c;
+    const float *p0, *p1, *c0, *c1;
+    int   i, j, k, steps, ix, iy, ch;
+    unsigned char *dst;
+
+    for (i = 0; i < num_segments; i++)
+    {
+        p0 = positions + 3 * i;
+        p1 = positions + 3 * ((i + 1) % num_segments);
+        c0 = colors + 4 * i;
+        c1 = colors + 4 * ((i + 1) % num_segments);
+
+        /* Perspective Divide, Camera on +z Looking at the Origin */
+        x0 = width  * 0.5f + focal * p0[0] * scale / (CAMERA_DISTANCE - p0[2] * scale);
+        y0 = height * 0.5f - focal * p0[1] * scale / (CAMERA_DISTANCE - p0[2] * scale);
+        x1 = width  * 0.5f + focal * p1[0] * scale / (CAMERA_DISTANCE - p1[2] * scale);
+        y1 = height * 0.5f - focal * p1[1] * scale / (CAMERA_DISTANCE - p1[2] * scale);
+
+        /* DDA Along the Major Axis */
+        steps = (int)ceilf(fmaxf(fabsf(x1 - x0), fabsf(y1 - y0)));
+        if (steps < 1) {
+            steps = 1;
+        }
+        for (j = 0; j <= steps; j++)
+        {
+            t  = (float)j / steps;
+            px = x0 + (x1 - x0) * t;
+            py = y0 + (y1 - y0) * t;
+
+            for (k = 0; k < 2; k++)
+            {
+                ix = (int)px + (fabsf(x1 - x0) < fabsf(y1 - y0) ? k : 0);
+                iy = (int)py + (fabsf(x1 - x0) < fabsf(y1 - y0) ? 0 : k);
+                if (ix < 0 || iy < 0 || ix >= width || iy >= height) {
+                    continue;
+                }
+                dst = pixels + 4 * (iy * width + ix);
+                for (ch = 0; ch < 3; ch++)
+                {
+                    c = c0[ch] + (c1[ch] - c0[ch]) * t;
+                    c = c < 0 ? 0 : (c > 1 ? 1 : c);
+                    dst[ch] = (unsigned char)(c * 255.0f + 0.5f);
+                }
+                dst[3] = 255;
+            }
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name: writePNGChunk()
+// Desc: Length, Type, Payload and CRC of One PNG Chunk
+//-----------------------------------------------------------------------------
+static void writePNGChunk(FILE *fp, const char *type, const unsigned char *payload, unsigned int length)
+{
+    unsigned char be[4];
+    uLong crc;
+
+    be[0] = length >> 24; be[1] = length >> 16; be[2] = length >> 8; be[3] = length;
+    fwrite(be, 1, 4, fp);
+    fwrite(type, 1, 4, fp);
+    if (length > 0) {
+        fwrite(payload, 1, length, fp);
+    }
+
+    crc = crc32(0L, (const Bytef*)type, 4);
+    crc = crc32(crc, payload, length);
+    be[0] = crc >> 24; be[1] = crc >> 16; be[2] = crc >> 8; be[3] = crc;
+    fwrite(be, 1, 4, fp);
+}
+
+//-----------------------------------------------------------------------------
+// Name: writeFrame()
+// Desc: Writes worker->pixels as Raw RGBA or an 8-bit RGBA PNG
+//-----------------------------------------------------------------------------
+static int writeFrame(exportWorker *worker, int frameNumber)
+{
+    exportBatch *batch = worker->batch;
+    int   w = batch->width, h = batch->height, y;
+    char  path[4096];
+    FILE* fp;
+    uLongf compressedLength = worker->compressedCapacity;
+    unsigned char ihdr[13] = { 0 };
+    static const unsigned char signature[8] = { 137, 'P', 'N', 'G', '\r', '\n', 26, '\n' };
+
+    snprintf(path, sizeof(path), "%s/frame_%06d.%s", batch->outDir, frameNumber, batch->png ? "png" : "rgba");
+    if ((fp = fopen(path, "wb")) == NULL) {
+        return -1;
+    }
+
+    if (!batch->png)
+    {
+        fwrite(worker->pixels, 4, (size_t)w * h, fp);
+        return fclose(fp);
+    }
+
+    /* Filter Type 0 on Every Scanline, Then One zlib Stream */
+    for (y = 0; y < h; y++)
+    {
+        worker->scanlines[y * (w * 4 + 1)] = 0;
+        memcpy(worker->scanlines + y * (w * 4 + 1) + 1, worker->pixels + y * w * 4, w * 4);
+    }
+    if (compress2(worker->compressed, &compressedLength, worker->scanlines,
+                  (uLong)(w * 4 + 1) * h, Z_BEST_SPEED) != Z_OK)
+    {
+        fclose(fp);
+        return -1;
+    }
+
+    ihdr[0] = w >> 24; ihdr[1] = w >> 16; ihdr[2] = w >> 8; ihdr[3] = w;
+    ihdr[4] = h >> 24; ihdr[5] = h >> 16; ihdr[6] = h >> 8; ihdr[7] = h;
+    ihdr[8] = 8;    // Bit Depth
+    ihdr[9] = 6;    // RGBA
+
+    fwrite(signature, 1, 8, fp);
+    writePNGChunk(fp, "IHDR", ihdr, 13);
+    writePNGChunk(fp, "IDAT", worker->compressed, (unsigned int)compressedLength);
+    writePNGChunk(fp, "IEND", NULL, 0);
+    return fclose(fp);
+}
+
+//-----------------------------------------------------------------------------
+// Name: exportWorkerMain()
+// Desc: Claims Frames of the Current Batch Until None Are Left
+//-----------------------------------------------------------------------------
+static void* exportWorkerMain(void *arg)
+{
+    exportWorker *worker = (exportWorker*)arg;
+    exportBatch  *batch  = worker->batch;
+    size_t frameBytes = (size_t)batch->width * batch->height * 4;
+    float  rms;
+    int    k, i, ring;
+
+    while ((k = atomic_fetch_add(&batch->next, 1)) < batch->numFrames)
+    {
+        /* Same Channels, Level of Detail, Geometry and Inner Ring Scale as displayFunc */
+        rms = batch->levels[k];
+        splitRingChannels(batch->ringMode, batch->snapshots[k][0], batch->snapshots[k][1],
+                          g_buffer_size, worker->outer, worker->inner);
+        generateRingGeometry(&g_ring_table,
+                             ringLOD(worker->outer, g_buffer_size, batch->numVertices, worker->envelope),
+                             batch->numVertices, RING_RADIUS, RING_DEPTH,
+                             worker->positions[0], worker->colors[0]);
+        ring = 0;
+        if (batch->ringMode != RING_MODE_MIX)
+        {
+            generateRingGeometry(&g_ring_table,
+                                 ringLOD(worker->inner, g_buffer_size, batch->numVertices, worker->envelope),
+                                 batch->numVertices, RING_RADIUS, RING_DEPTH,
+                                 worker->positions[1], worker->colors[1]);
+            ring = 1;
+        }
+
+        /* Opaque Black, Like glClearColor but Without the Transparency */
+        memset(worker->pixels, 0, frameBytes);
+        for (i = 3; i < (int)frameBytes; i += 4) {
+            worker->pixels[i] = 255;
+        }
+        rasterizeRing(worker->pixels, batch->width, batch->height,
+                      worker->positions[0], worker->colors[0], batch->numVertices, 1.0f);
+        rasterizeRing(worker->pixels, batch->width, batch->height,
+                      worker->positions[ring], worker->colors[ring], batch->numVertices,
+                      (rms * 2 + 0.3f) / 1.5f);
+
+        if (writeFrame(worker, batch->firstFrame + k) != 0) {
+            worker->failed = 1;
+        }
+    }
+    return NULL;
+}
+
+//-----------------------------------------------------------------------------
+// Name: int runExport(const char* outDir)
+// Desc: Runs the DSP Chain Offline Over the Whole File, Writing the Processed
+//       WAV and One Image per Video Frame. The Chain is Serial, so Snapshots
+//       are Collected a Batch at a Time and Rendered Across Every Core. The
+//       Platter Turns Over a Cache Filled Between Blocks, so Direction, Motor
+//       and Scratching Render Just as They Play.
+//-----------------------------------------------------------------------------
+int runExport(const char* outDir)
+{
+    static exportBatch batch;
+    exportWorker workers[EXPORT_MAX_THREADS];
+    pthread_t    threads[EXPORT_MAX_THREADS];
+    float   out[FRAMES_PER_BUFFER * STEREO];
+    char    path[4096];
+    SNDFILE* wavFile;
+    SF_INFO wavInfo;
+    int     numThreads = g_options.export_threads;
+    int     fps = g_options.export_fps;
+    int     t, frame = 0, numVideoFrames, failed = 0;
+    long    block, numBlocks, blockStart, frameSample, latency, visualDelay;
+    double  start, elapsed, duration;
+    sf_count_t remaining, skip, count;
+
+    /* Build the Chain Exactly as Playback Does, the Reader's Work Done Here */
+    initialize_engine(g_options.inFile, g_options.deckFile);
+    initialize_frameCache(&data.cache, g_options.inFile, false);
+    if (deckB.inFile != NULL) {
+        initialize_frameCache(&deckB.cache, g_options.deckFile, false);
+    }
+    updateRingTable(&g_ring_table, ringLODVertices(g_buffer_size, g_options.export_height));
+
+    if (mkdir(outDir, 0755) != 0 && errno != EEXIST)
+    {
+        printf("Error, Couldn't Create %s\n", outDir);
+        return EXIT_FAILURE;
+    }
+
+    /* Processed Audio */
+    memset(&wavInfo, 0, sizeof(wavInfo));
+    wavInfo.samplerate = data.sfinfo1.samplerate;
+    wavInfo.channels   = data.sfinfo1.channels;
+    wavInfo.format     = SF_FORMAT_WAV | SF_FORMAT_PCM_24;
+    snprintf(path, sizeof(path), "%s/audio.wav", outDir);
+    if ((wavFile = sf_open(path, SFM_WRITE, &wavInfo)) == NULL)
+    {
+        printf("Error, Couldn't Open %s\n", path);
+        return EXIT_FAILURE;
+    }
+
+    /* Threads and Their Scratch */
+    if (numThreads <= 0) {
+        numThreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    if (numThreads < 1) {
+        numThreads = 1;
+    }
+    if (numThreads > EXPORT_MAX_THREADS) {
+        numThreads = EXPORT_MAX_THREADS;
+    }
+    batch.outDir = outDir;
+    batch.width  = g_options.export_width;
+    batch.height = g_options.export_height;
+    batch.png    = g_options.export_png;
+    batch.numVertices = g_ring_table.segments;
+    batch.ringMode = g_ring_mode;
+    for (t = 0; t < numThreads; t++)
+    {
+        memset(&workers[t], 0, sizeof(workers[t]));
+        workers[t].batch  = &batch;
+        workers[t].pixels = malloc((size_t)batch.width * batch.height * 4);
+        if (batch.png)
+        {
+            workers[t].compressedCapacity = compressBound((uLong)(batch.width * 4 + 1) * batch.height);
+            workers[t].scanlines  = malloc((size_t)(batch.width * 4 + 1) * batch.height);
+            workers[t].compressed = malloc(workers[t].compressedCapacity);
+        }
+        if (workers[t].pixels == NULL || (batch.png && (workers[t].scanlines == NULL || workers[t].compressed == NULL)))
+        {
+            printf("Error, Out of Memory for %d Export Threads at %dx%d\n", numThreads, batch.width, batch.height);
+            for (; t >= 0; t--)
+            {
+                free(workers[t].pixels);
+                free(workers[t].scanlines);
+                free(workers[t].compressed);
+            }
+            sf_close(wavFile);
+            return EXIT_FAILURE;
+        }
+    }
+
+    /* The Filters and the Limiter's Lookahead Delay the Output, so the WAV
+       Drops That Much From its Start and Runs That Much Past the End to Line
+       Up With the Source. Rings are Written Before the Limiter and Only Wait
+       Out the Filters. */
+    latency     = data.limiter.lookahead + OVERSAMPLE_LATENCY;
+    visualDelay = OVERSAMPLE_LATENCY;
+
+    duration       = (double)data.sfinfo1.frames / data.sfinfo1.samplerate;
+    numBlocks      = (long)((data.sfinfo1.frames + latency + FRAMES_PER_BUFFER - 1) / FRAMES_PER_BUFFER);
+    numVideoFrames = (int)(duration * fps);
+    remaining      = data.sfinfo1.frames;
+
+    printf("Exporting %d Frames at %d fps, %dx%d, %d Threads\n",
+        numVideoFrames, fps, batch.width, batch.height, numThreads);
+
+    start = getTimeSeconds();
+    batch.firstFrame = 0;
+    batch.numFrames  = 0;
+
+    for (block = 0; block < numBlocks; block++)
+    {
+        frameCacheService(&data.cache);
+        frameCacheService(&deckB.cache);
+        automationProcess(&data, out, FRAMES_PER_BUFFER);
+        drainAutomation(&data.automation);
+
+        /* Skip the Limiter's Delay, the Last Block Only Writes What is Left of the File */
+        blockStart = block * FRAMES_PER_BUFFER;
+        skip  = latency > blockStart ? latency - blockStart : 0;
+        if (skip > FRAMES_PER_BUFFER) {
+            skip = FRAMES_PER_BUFFER;
+        }
+        count = FRAMES_PER_BUFFER - skip;
+        if (count > remaining) {
+            count = remaining;
+        }
+        if (count > 0)
+        {
+            sf_writef_float(wavFile, out + skip * data.sfinfo1.channels, count);
+            remaining -= count;
+        }
+
+        /* Every Video Frame Whose Timestamp Lands in This Block Sees This Block */
+        while (frame < numVideoFrames)
+        {
+            frameSample = (long)((double)frame * data.sfinfo1.samplerate / fps) + visualDelay;
+            if (frameSample >= blockStart + FRAMES_PER_BUFFER) {
+                break;
+            }
+            batch.levels[batch.numFrames] = atomic_load(&data.envelope.rmsMix);
+            if (batch.ringMode == RING_MODE_DECKS) {
+                readDeckRings(batch.snapshots[batch.numFrames][0], batch.snapshots[batch.numFrames][1], g_buffer_size);
+            }
+            else {
+                channelHistoryRead(&data.history, batch.snapshots[batch.numFrames][0],
+                                   batch.snapshots[batch.numFrames][1], g_buffer_size);
+            }
+            batch.numFrames++;
+            frame++;
+
+            /* Batch Full or Audio Done, Render it Across Every Core */
+            if (batch.numFrames == EXPORT_BATCH_FRAMES || frame == numVideoFrames)
+            {
+                atomic_store(&batch.next, 0);
+                for (t = 0; t < numThreads; t++) {
+                    pthread_create(&threads[t], NULL, exportWorkerMain, &workers[t]);
+                    pinThread(threads[t], RT_THREAD_RENDER);
+                }
+                for (t = 0; t < numThreads; t++) {
+                    pthread_join(threads[t], NULL);
+                }
+                batch.firstFrame += batch.numFrames;
+                batch.numFrames = 0;
+                printf("\rFrame %d/%d", frame, numVideoFrames);
+                fflush(stdout);
+            }
+        }
+    }
+
+    elapsed = getTimeSeconds() - start;
+    sf_close(wavFile);
+
+    for (t = 0; t < numThreads; t++)
+    {
+        failed |= workers[t].failed;
+        free(workers[t].pixels);
+        free(workers[t].scanlines);
+        free(workers[t].compressed);
+    }
+
+    printf("\nExported %.1fs of Audio in %.1fs (%.1fx Realtime)\n",
+        duration, elapsed, elapsed > 0 ? duration / elapsed : 0);
+    if (failed) {
+        printf("Error, Some Frames Could Not be Written to %s\n", outDir);
+    }
+
+    stop_frameCache(&data.cache);
+    stop_governor(&data.governor);
+    sf_close(data.inFile);
+    if (deckB.inFile != NULL)
+    {
+        stop_frameCache(&deckB.cache);
+        stop_governor(&deckB.governor);
+        sf_close(deckB.inFile);
+    }
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+//-----------------------------------------------------------------------------
+// Batch Analysis
+//-----------------------------------------------------------------------------
+
+/* One Input File, Chunk Results Merge Into it as They Finish */
+typedef struct {
+    const char*     path;
+    char            error[96];                  // Empty When the Features Are Valid
+    int             sampleRate;
+    int             numChannels;
+    sf_count_t      frames;
+    atomic_int      chunksLeft;
+
+    /* Partial Results, Merged Under lock */
+    pthread_mutex_t lock;
+    float           peak;
+    double          sumSquares;
+    double          centroidNum, centroidDen;
+    loudnessMeter*  loudness;                   // Only its Gating Histogram and True Peak
+    float*          onsets;                     // Spectral Flux per FFT Hop, Chunks Fill Disjoint Ranges
+    int             numOnsets;
+
+    /* Features */
+    double          duration, peakDb, truePeakDb, rmsDb, lufs, centroid, bpm;
+} analysisFile;
+
+/* A Whole File to Plan, or One Frame Range of it */
+typedef struct {
+    analysisFile*   file;
+    sf_count_t      start, end;                 // end < 0 Plans the File
+} analysisTask;
+
+/* Per-Worker Deque. The Owner Pushes and Pops at the Tail, Newest and Still
+   in Cache, Thieves Take From the Head, Oldest and Usually the Most Work. */
+typedef struct {
+    pthread_mutex_t lock;
+    analysisTask*   tasks;
+    int             head, tail, capacity;
+} taskDeque;
+
+struct analysisPool;
+
+/* Per-Thread Scratch, Reused for Every Task That Thread Runs */
+typedef struct {
+    struct analysisPool* pool;
+    int             index;
+    float*          buffer;                     // Interleaved Preroll + Chunk + FFT Tail
+    float*          mono;
+    sf_count_t      capacity;                   // Frames
+    loudnessMeter   meter;
+    float           re[ANALYZE_FFT_SIZE];
+    float           im[ANALYZE_FFT_SIZE];
+    float           magnitude[2][ANALYZE_FFT_SIZE / 2 + 1];
+} analysisWorker;
+
+typedef struct analysisPool {
+    taskDeque       deques[ANALYZE_MAX_THREADS];
+    analysisWorker  workers[ANALYZE_MAX_THREADS];
+    int             numWorkers;
+    atomic_int      pending;                    // Tasks Queued or Running
+    float           window[ANALYZE_FFT_SIZE];   // Hann
+    float           cosTable[ANALYZE_FFT_SIZE / 2];
+    float           sinTable[ANALYZE_FFT_SIZE / 2];
+} analysisPool;
+
+//-----------------------------------------------------------------------------
+// Name: pushTask() / popTask() / stealTask()
+// Desc: Deque Operations. Tasks Run for Milliseconds to Seconds, so One Short
+//       Lock per Deque Never Shows Up Next to the Work Itself. pushTask()
+//       Returns false, Leaving the Deque as it Was, if it Can't Grow.
+//-----------------------------------------------------------------------------
+static bool pushTask(taskDeque *dq, analysisTask task)
+{
+    analysisTask *tasks;
+    int capacity;
+
+    pthread_mutex_lock(&dq->lock);
+    if (dq->tail == dq->capacity)
+    {
+        /* Reclaim Stolen Slots First, Grow Only When the Deque is Really Full */
+        if (dq->head > 0)
+        {
+            memmove(dq->tasks, dq->tasks + dq->head, (dq->tail - dq->head) * sizeof(analysisTask));
+            dq->tail -= dq->head;
+            dq->head  = 0;
+        }
+        else
+        {
+            capacity = dq->capacity ? dq->capacity * 2 : 64;
+            if ((tasks = realloc(dq->tasks, capacity * sizeof(analysisTask))) == NULL)
+            {
+                pthread_mutex_unlock(&dq->lock);
+                return false;
+            }
+            dq->tasks    = tasks;
+            dq->capacity = capacity;
+        }
+    }
+    dq->tasks[dq->tail++] = task;
+    pthread_mutex_unlock(&dq->lock);
+    return true;
+}
+
+static bool popTask(taskDeque *dq, analysisTask *task)
+{
+    bool found = false;
+
+    pthread_mutex_lock(&dq->lock);
+    if (dq->tail > dq->head)
+    {
+        *task = dq->tasks[--dq->tail];
+        found = true;
+    }
+    pthread_mutex_unlock(&dq->lock);
+    return found;
+}
+
+static bool stealTask(taskDeque *dq, analysisTask *task)
+{
+    bool found = false;
+
+    pthread_mutex_lock(&dq->lock);
+    if (dq->tail > dq->head)
+    {
+        *task = dq->tasks[dq->head++];
+        found = true;
+    }
+    pthread_mutex_unlock(&dq->lock);
+    return found;
+}
+
+//-----------------------------------------------------------------------------
+// Name: fftRadix2()
+// Desc: In-Place Iterative Forward FFT, n a Power of Two. Twiddles Come From
+//       cos/sin Tables of Length n/2 Taken With a Stride for Shorter Stages.
+//-----------------------------------------------------------------------------
+static void fftRadix2(float *re, float *im, int n, const float *cosTable, const float *sinTable)
+{
+    int   i, j, k, len, half, step;
+    float tr, ti, wr, wi;
+
+    /* Bit-Reversal Permutation */
+    for (i = 1, j = 0; i < n; i++)
+    {
+        for (k = n >> 1; j & k; k >>= 1) {
+            j ^= k;
+        }
+        j |= k;
+        if (i < j)
+        {
+            tr = re[i]; re[i] = re[j]; re[j] = tr;
+            ti = im[i]; im[i] = im[j]; im[j] = ti;
+        }
+    }
+
+    /* Butterflies */
+    for (len = 2; len <= n; len <<= 1)
+    {
+        half = len >> 1;
+        step = n / len;
+        for (i = 0; i < n; i += len)
+        {
+            for (k = 0; k < half; k++)
+            {
+                wr =  cosTable[k * step];
+                wi = -sinTable[k * step];
+                tr = re[i + k + half] * wr - im[i + k + half] * wi;
+                ti = re[i + k + half] * wi + im[i + k + half] * wr;
+                re[i + k + half] = re[i + k] - tr;
+                im[i + k + half] = im[i + k] - ti;
+                re[i + k] += tr;
+                im[i + k] += ti;
+            }
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name: analysisSpectrum()
+// Desc: Hann-Windowed Magnitude Spectrum of the Mono Mix Starting at offset,
+//       Zero Past the End of What Was Read
+//-----------------------------------------------------------------------------
+static void analysisSpectrum(analysisWorker *w, sf_count_t offset, sf_count_t available, float *magnitude)
+{
+    analysisPool *pool = w->pool;
+    int k;
+
+    for (k = 0; k < ANALYZE_FFT_SIZE; k++)
+    {
+        w->re[k] = offset + k < available ? w->mono[offset + k] * pool->window[k] : 0.0f;
+        w->im[k] = 0.0f;
+    }
+    fftRadix2(w->re, w->im, ANALYZE_FFT_SIZE, pool->cosTable, pool->sinTable);
+
+    for (k = 0; k <= ANALYZE_FFT_SIZE / 2; k++) {
+        magnitude[k] = sqrtf(w->re[k] * w->re[k] + w->im[k] * w->im[k]);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name: estimateTempo()
+// Desc: Autocorrelates the Onset Envelope Over the Lags of 60-200 BPM, Weighted
+//       Toward 120 BPM on a Log Scale to Settle Octave Ambiguity, Then Refines
+//       the Best Lag With a Parabola. Returns 0 When There is No Pulse.
+//-----------------------------------------------------------------------------
+static double estimateTempo(const float *onsets, int numOnsets, double onsetRate)
+{
+    int    minLag = (int)floor(onsetRate * 60.0 / ANALYZE_MAX_BPM);
+    int    maxLag = (int)ceil(onsetRate * 60.0 / ANALYZE_MIN_BPM);
+    int    lag, i, best = -1;
+    double mean = 0, variance = 0, acf, octaves, offset = 0, a, b, c;
+    double scores[maxLag + 2], pulse[maxLag + 2];
+
+    if (minLag < 1 || numOnsets < 2 * maxLag) {
+        return 0;
+    }
+
+    for (i = 0; i < numOnsets; i++) {
+        mean += onsets[i];
+    }
+    mean /= numOnsets;
+    for (i = 0; i < numOnsets; i++) {
+        variance += (onsets[i] - mean) * (onsets[i] - mean);
+    }
+    variance /= numOnsets;
+    if (variance <= 0) {
+        return 0;
+    }
+
+    for (lag = minLag; lag <= maxLag + 1; lag++)
+    {
+        acf = 0;
+        for (i = 0; i + lag < numOnsets; i++) {
+            acf += (onsets[i] - mean) * (onsets[i + lag] - mean);
+        }
+        octaves = log2(60.0 * onsetRate / lag / ANALYZE_BPM_PRIOR);
+        pulse[lag]  = acf / (numOnsets - lag) / variance;
+        scores[lag] = pulse[lag] * exp(-0.5 * octaves * octaves);
+
+        if (lag <= maxLag && scores[lag] > 0 && (best < 0 || scores[lag] > scores[best])) {
+            best = lag;
+        }
+    }
+    if (best < 0 || pulse[best] < ANALYZE_MIN_PULSE) {
+        return 0;
+    }
+
+    /* Sub-Lag Peak */
+    if (best > minLag)
+    {
+        a = scores[best - 1];
+        b = scores[best];
+        c = scores[best + 1];
+        if (a - 2 * b + c < 0) {
+            offset = 0.5 * (a - c) / (a - 2 * b + c);
+        }
+    }
+    return 60.0 * onsetRate / (best + offset);
+}
+
+//-----------------------------------------------------------------------------
+// Name: finishAnalysisFile()
+// Desc: Turns the Merged Partials Into Features, Run by the Last Chunk to Land
+//-----------------------------------------------------------------------------
+static void finishAnalysisFile(analysisFile *f)
+{
+    if (f->error[0] == '\0')
+    {
+        f->duration   = (double)f->frames / f->sampleRate;
+        f->peakDb     = f->peak > 0 ? 20.0 * log10(f->peak) : LOUDNESS_SILENCE;
+        f->truePeakDb = f->loudness->tpMax > 0 ? 20.0 * log10(f->loudness->tpMax) : LOUDNESS_SILENCE;
+        f->rmsDb      = f->sumSquares > 0 ? 10.0 * log10(f->sumSquares / ((double)f->frames * f->numChannels))
+                                          : LOUDNESS_SILENCE;
+        f->lufs       = gatedLoudness(f->loudness);
+        f->centroid   = f->centroidDen > 0 ? f->centroidNum / f->centroidDen : 0;
+        f->bpm        = estimateTempo(f->onsets, f->numOnsets, (double)f->sampleRate / ANALYZE_FFT_HOP);
+    }
+
+    free(f->loudness);
+    free(f->onsets);
+    f->loudness = NULL;
+    f->onsets   = NULL;
+}
+
+//-----------------------------------------------------------------------------
+// Name: analyzeChunk()
+// Desc: Features of Frames [start, end). Loudness Hops Before start Are Read
+//       Again as Preroll so the 400ms Gating Blocks of Neighbouring Chunks Tile
+//       the File Exactly, and the FFT Reads On Past end to Finish its Frames.
+//-----------------------------------------------------------------------------
+static void analyzeChunk(analysisWorker *w, analysisFile *f, sf_count_t start, sf_count_t end)
+{
+    int        numChannels = f->numChannels;
+    int        hopFrames = f->sampleRate * LOUDNESS_HOP_MS / 1000;
+    sf_count_t readStart, readEnd, numFrames, got, i;
+    sf_count_t firstHop, lastHop, j;
+    double     sumSquares = 0, centroidNum = 0, centroidDen = 0, flux;
+    double     binHz = (double)f->sampleRate / ANALYZE_FFT_SIZE;
+    float      peak = 0, *previous, *current, *swap, *grown;
+    int        k, bin;
+    SNDFILE*   fp;
+    SF_INFO    info;
+
+    readStart = start - ANALYZE_PREROLL_HOPS * hopFrames;
+    if (readStart < 0) {
+        readStart = 0;
+    }
+    readEnd = end + ANALYZE_FFT_SIZE;
+    if (readEnd > f->frames) {
+        readEnd = f->frames;
+    }
+    numFrames = readEnd - readStart;
+
+    /* Scratch Only Grows Once Both Buffers Have, Out of Memory Fails the File */
+    if (numFrames > w->capacity)
+    {
+        if ((grown = realloc(w->buffer, numFrames * STEREO * sizeof(float))) != NULL)
+        {
+            w->buffer = grown;
+            if ((grown = realloc(w->mono, numFrames * sizeof(float))) != NULL)
+            {
+                w->mono     = grown;
+                w->capacity = numFrames;
+            }
+        }
+        if (grown == NULL)
+        {
+            pthread_mutex_lock(&f->lock);
+            snprintf(f->error, sizeof(f->error), "Out of Memory");
+            pthread_mutex_unlock(&f->lock);
+            goto done;
+        }
+    }
+
+    /* Every Chunk Opens its Own Handle so Any Thread Can Run it */
+    memset(&info, 0, sizeof(info));
+    if ((fp = sf_open(f->path, SFM_READ, &info)) == NULL)
+    {
+        pthread_mutex_lock(&f->lock);
+        snprintf(f->error, sizeof(f->error), "%s", sf_strerror(NULL));
+        pthread_mutex_unlock(&f->lock);
+        goto done;
+    }
+    got = 0;
+    if (sf_seek(fp, readStart, SEEK_SET) >= 0) {
+        got = sf_readf_float(fp, w->buffer, numFrames);
+    }
+    sf_close(fp);
+    if (got < 0) {
+        got = 0;
+    }
+    memset(w->buffer + got * numChannels, 0, (numFrames - got) * numChannels * sizeof(float));
+
+    /* Loudness and True Peak, Preroll Included */
+    initialize_loudnessMeter(&w->meter, f->sampleRate, numChannels);
+    loudnessMeterProcess(&w->meter, w->buffer, (int)(end - readStart));
+
+    /* Sample Peak and RMS Over the Chunk Alone */
+    for (i = (start - readStart) * numChannels; i < (end - readStart) * numChannels; i++)
+    {
+        sumSquares += (double)w->buffer[i] * w->buffer[i];
+        if (fabsf(w->buffer[i]) > peak) {
+            peak = fabsf(w->buffer[i]);
+        }
+    }
+
+    /* Mono Mix for the Spectrum */
+    for (i = 0; i < numFrames; i++)
+    {
+        w->mono[i] = numChannels == STEREO ? 0.5f * (w->buffer[2 * i] + w->buffer[2 * i + 1])
+                                           : w->buffer[i];
+    }
+
+    /* FFT Frames Starting in the Chunk, Flux Against the Frame Before */
+    firstHop = (start + ANALYZE_FFT_HOP - 1) / ANALYZE_FFT_HOP;
+    lastHop  = (end + ANALYZE_FFT_HOP - 1) / ANALYZE_FFT_HOP;
+    if (lastHop > f->numOnsets) {
+        lastHop = f->numOnsets;
+    }
+    previous = w->magnitude[0];
+    current  = w->magnitude[1];
+    if (firstHop > 0) {
+        analysisSpectrum(w, (firstHop - 1) * ANALYZE_FFT_HOP - readStart, numFrames, previous);
+    }
+    else {
+        memset(previous, 0, sizeof(w->magnitude[0]));
+    }
+
+    for (j = firstHop; j < lastHop; j++)
+    {
+        analysisSpectrum(w, j * ANALYZE_FFT_HOP - readStart, numFrames, current);
+
+        flux = 0;
+        for (bin = 1; bin <= ANALYZE_FFT_SIZE / 2; bin++)
+        {
+            float rise = log1pf(current[bin]) - log1pf(previous[bin]);
+            if (rise > 0) {
+                flux += rise;
+            }
+            centroidNum += bin * binHz * current[bin];
+            centroidDen += current[bin];
+        }
+        f->onsets[j] = (float)flux;
+
+        swap = previous; previous = current; current = swap;
+    }
+
+    /* Merge Into the File */
+    pthread_mutex_lock(&f->lock);
+    if (peak > f->peak) {
+        f->peak = peak;
+    }
+    f->sumSquares  += sumSquares;
+    f->centroidNum += centroidNum;
+    f->centroidDen += centroidDen;
+    for (k = 0; k < LOUDNESS_HIST_BINS; k++)
+    {
+        f->loudness->histEnergy[k] += w->meter.histEnergy[k];
+        f->loudness->histCount[k]  += w->meter.histCount[k];
+    }
+    f->loudness->gatedEnergy += w->meter.gatedEnergy;
+    f->loudness->gatedCount  += w->meter.gatedCount;
+    if (w->meter.tpMax > f->loudness->tpMax) {
+        f->loudness->tpMax = w->meter.tpMax;
+    }
+    pthread_mutex_unlock(&f->lock);
+
+done:
+    if (atomic_fetch_sub(&f->chunksLeft, 1) == 1) {
+        finishAnalysisFile(f);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name: planAnalysisFile()
+// Desc: Opens the File, Then Queues Every Chunk But the First on This Worker's
+//       Deque for Idle Workers to Steal and Runs the First Right Away
+//-----------------------------------------------------------------------------
+static void planAnalysisFile(analysisWorker *w, analysisFile *f)
+{
+    SF_INFO      info;
+    SNDFILE*     fp;
+    sf_count_t   chunkFrames;
+    analysisTask task;
+    int          c, numChunks;
+
+    memset(&info, 0, sizeof(info));
+    if ((fp = sf_open(f->path, SFM_READ, &info)) == NULL)
+    {
+        snprintf(f->error, sizeof(f->error), "%s", sf_strerror(NULL));
+        return;
+    }
+    sf_close(fp);
+
+    if (info.channels < MONO || info.channels > STEREO)
+    {
+        snprintf(f->error, sizeof(f->error), "Unsupported Channel Count %d", info.channels);
+        return;
+    }
+    if (info.frames <= 0)
+    {
+        snprintf(f->error, sizeof(f->error), "Empty File");
+        return;
+    }
+
+    f->sampleRate  = info.samplerate;
+    f->numChannels = info.channels;
+    f->frames      = info.frames;
+    f->numOnsets   = (int)((info.frames + ANALYZE_FFT_HOP - 1) / ANALYZE_FFT_HOP);
+    f->onsets      = calloc(f->numOnsets, sizeof(float));
+    f->loudness    = malloc(sizeof(loudnessMeter));
+    if (f->onsets == NULL || f->loudness == NULL)
+    {
+        free(f->onsets);
+        free(f->loudness);
+        f->onsets   = NULL;
+        f->loudness = NULL;
+        snprintf(f->error, sizeof(f->error), "Out of Memory");
+        return;
+    }
+    initialize_loudnessMeter(f->loudness, info.samplerate, info.channels);
+
+    /* Chunks Are Whole Loudness Hops */
+    chunkFrames = (sf_count_t)ANALYZE_CHUNK_HOPS * (info.samplerate * LOUDNESS_HOP_MS / 1000);
+    numChunks   = (int)((info.frames + chunkFrames - 1) / chunkFrames);
+    atomic_store(&f->chunksLeft, numChunks);
+
+    /* Count Them Before Queueing so the Pool Never Looks Drained */
+    atomic_fetch_add(&w->pool->pending, numChunks - 1);
+    for (c = numChunks - 1; c >= 1; c--)
+    {
+        task.file  = f;
+        task.start = c * chunkFrames;
+        task.end   = task.start + chunkFrames < info.frames ? task.start + chunkFrames : info.frames;
+
+        /* A Chunk That Can't be Queued Fails the File, but Still Counts as Done */
+        if (!pushTask(&w->pool->deques[w->index], task))
+        {
+            pthread_mutex_lock(&f->lock);
+            snprintf(f->error, sizeof(f->error), "Out of Memory");
+            pthread_mutex_unlock(&f->lock);
+            atomic_fetch_sub(&f->chunksLeft, 1);
+            atomic_fetch_sub(&w->pool->pending, 1);
+        }
+    }
+
+    analyzeChunk(w, f, 0, chunkFrames < info.frames ? chunkFrames : info.frames);
+}
+
+//-----------------------------------------------------------------------------
+// Name: analysisWorkerMain()
+// Desc: Runs Its Own Tasks Newest First, Steals the Oldest From the Others
+//       When it Runs Dry, and Quits Once No Task is Queued or Running
+//-----------------------------------------------------------------------------
+static void* analysisWorkerMain(void *arg)
+{
+    analysisWorker *w = (analysisWorker*)arg;
+    analysisPool   *pool = w->pool;
+    analysisTask    task;
+    struct timespec nap = { 0, 200000 };
+    bool found;
+    int  v;
+
+    for (;;)
+    {
+        found = popTask(&pool->deques[w->index], &task);
+        for (v = 1; !found && v < pool->numWorkers; v++) {
+            found = stealTask(&pool->deques[(w->index + v) % pool->numWorkers], &task);
+        }
+
+        if (found)
+        {
+            if (task.end < 0) {
+                planAnalysisFile(w, task.file);
+            }
+            else {
+                analyzeChunk(w, task.file, task.start, task.end);
+            }
+            atomic_fetch_sub(&pool->pending, 1);
+        }
+        else if (atomic_load(&pool->pending) == 0) {
+            break;
+        }
+        else {
+            nanosleep(&nap, NULL);
+        }
+    }
+    return NULL;
+}
+
+//-----------------------------------------------------------------------------
+// Name: writeCSVField() / writeJSONString()
+// Desc: Quoted Path Output That Survives Commas, Quotes and Control Characters
+//-----------------------------------------------------------------------------
+static void writeCSVField(FILE *fp, const char *s)
+{
+    fputc('"', fp);
+    for (; *s; s++)
+    {
+        if (*s == '"') {
+            fputc('"', fp);
+        }
+        fputc(*s, fp);
+    }
+    fputc('"', fp);
+}
+
+static void writeJSONString(FILE *fp, const char *s)
+{
+    fputc('"', fp);
+    for (; *s; s++)
+    {
+        if (*s == '"' || *s == '\\') {
+            fprintf(fp, "\\%c", *s);
+        }
+        else if ((unsigned char)*s < 0x20) {
+            fprintf(fp, "\\u%04x", (unsigned char)*s);
+        }
+        else {
+            fputc(*s, fp);
+        }
+    }
+    fputc('"', fp);
+}
+
+//-----------------------------------------------------------------------------
+// Name: writeAnalysis()
+// Desc: One Row or Object per Input, in Input Order. Failed Files Keep Their
+//       Row With Empty (CSV) or null (JSON) Features and the Reason.
+//-----------------------------------------------------------------------------
+static void writeAnalysis(FILE *fp, const analysisFile *files, int numFiles, bool json)
+{
+    const analysisFile *f;
+    int i;
+
+    if (json) {
+        fprintf(fp, "[\n");
+    }
+    else {
+        fprintf(fp, "path,duration_s,sample_rate,channels,peak_dbfs,true_peak_dbtp,rms_dbfs,"
+                    "lufs,centroid_hz,tempo_bpm,error\n");
+    }
+
+    for (i = 0; i < numFiles; i++)
+    {
+        f = &files[i];
+        if (json)
+        {
+            fprintf(fp, "  {\"path\": ");
+            writeJSONString(fp, f->path);
+            if (f->error[0] == '\0')
+            {
+                fprintf(fp, ", \"duration_s\": %.3f, \"sample_rate\": %d, \"channels\": %d, "
+                            "\"peak_dbfs\": %.2f, \"true_peak_dbtp\": %.2f, \"rms_dbfs\": %.2f, "
+                            "\"lufs\": %.2f, \"centroid_hz\": %.1f, \"tempo_bpm\": %.2f, \"error\": null}",
+                    f->duration, f->sampleRate, f->numChannels, f->peakDb, f->truePeakDb,
+                    f->rmsDb, f->lufs, f->centroid, f->bpm);
+            }
+            else
+            {
+                fprintf(fp, ", \"duration_s\": null, \"sample_rate\": null, \"channels\": null, "
+                            "\"peak_dbfs\": null, \"true_peak_dbtp\": null, \"rms_dbfs\": null, "
+                            "\"lufs\": null, \"centroid_hz\": null, \"tempo_bpm\": null, \"error\": ");
+                writeJSONString(fp, f->error);
+                fputc('}', fp);
+            }
+            fprintf(fp, i + 1 < numFiles ? ",\n" : "\n");
+        }
+        else
+        {
+            writeCSVField(fp, f->path);
+            if (f->error[0] == '\0')
+            {
+                fprintf(fp, ",%.3f,%d,%d,%.2f,%.2f,%.2f,%.2f,%.1f,%.2f,\n",
+                    f->duration, f->sampleRate, f->numChannels, f->peakDb, f->truePeakDb,
+                    f->rmsDb, f->lufs, f->centroid, f->bpm);
+            }
+            else
+            {
+                fprintf(fp, ",,,,,,,,,,");
+                writeCSVField(fp, f->error);
+                fputc('\n', fp);
+            }
+        }
+    }
+
+    if (json) {
+        fprintf(fp, "]\n");
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name: int runAnalysis()
+// Desc: Extracts Duration, Peak, RMS, Loudness, Spectral Centroid and Tempo
+//       for Every Input on a Work-Stealing Pool, One Task per File, Large
+//       Files Split Into Chunks Other Workers Steal
+//-----------------------------------------------------------------------------
+int runAnalysis()
+{
+    static analysisPool pool;
+    pthread_t     threads[ANALYZE_MAX_THREADS];
+    analysisFile* files;
+    analysisTask  task;
+    const char**  paths = NULL;
+    const char**  grown;
+    char          line[4096];
+    FILE*         fp;
+    int     numPaths = 0, capacity = 0, numThreads = g_options.export_threads;
+    int     i, t, failed = 0;
+    double  start, elapsed, audio = 0;
+    size_t  length;
+    bool    outOfMemory = false;
+
+    /* Inputs From the Command Line, Then One Path per Line of the List */
+    capacity = g_options.numInputs + 64;
+    if ((paths = malloc(capacity * sizeof(char*))) == NULL)
+    {
+        fprintf(stderr, "Error, Out of Memory for the File List\n");
+        return EXIT_FAILURE;
+    }
+    for (i = 0; i < g_options.numInputs; i++) {
+        paths[numPaths++] = g_options.inputs[i];
+    }
+    if (g_options.analyzeList != NULL)
+    {
+        fp = strcmp(g_options.analyzeList, "-") == 0 ? stdin : fopen(g_options.analyzeList, "r");
+        if (fp == NULL)
+        {
+            fprintf(stderr, "Error, Couldn't Open %s\n", g_options.analyzeList);
+            return EXIT_FAILURE;
+        }
+        while (fgets(line, sizeof(line), fp) != NULL)
+        {
+            length = strcspn(line, "\r\n");
+            line[length] = '\0';
+            if (length == 0) {
+                continue;
+            }
+            if (numPaths == capacity)
+            {
+                if ((grown = realloc(paths, capacity * 2 * sizeof(char*))) == NULL)
+                {
+                    outOfMemory = true;
+                    break;
+                }
+                paths     = grown;
+                capacity *= 2;
+            }
+            if ((paths[numPaths] = strdup(line)) == NULL)
+            {
+                outOfMemory = true;
+                break;
+            }
+            numPaths++;
+        }
+
+        if (fp != stdin) {
+            fclose(fp);
+        }
+
+        /* A List That Didn't Fit is Not Analyzed Halfway */
+        if (outOfMemory)
+        {
+            fprintf(stderr, "Error, Out of Memory Reading %s After %d Files\n", g_options.analyzeList, numPaths);
+            for (i = g_options.numInputs; i < numPaths; i++) {
+                free((char*)paths[i]);
+            }
+            free(paths);
+            return EXIT_FAILURE;
+        }
+    }
+    if (numPaths == 0)
+    {
+        fprintf(stderr, "Error, No Files to Analyze\n");
+        return EXIT_FAILURE;
+    }
+
+    if (numThreads <= 0) {
+        numThreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    if (numThreads < 1) {
+        numThreads = 1;
+    }
+    if (numThreads > ANALYZE_MAX_THREADS) {
+        numThreads = ANALYZE_MAX_THREADS;
+    }
+
+    /* Shared Tables */
+    for (i = 0; i < ANALYZE_FFT_SIZE; i++) {
+        pool.window[i] = (float)(0.5 - 0.5 * cos(2.0 * PI * i / ANALYZE_FFT_SIZE));
+    }
+    for (i = 0; i < ANALYZE_FFT_SIZE / 2; i++)
+    {
+        pool.cosTable[i] = (float)cos(2.0 * PI * i / ANALYZE_FFT_SIZE);
+        pool.sinTable[i] = (float)sin(2.0 * PI * i / ANALYZE_FFT_SIZE);
+    }
+
+    /* Deal the Files Round Robin, Stealing Evens Out the Rest */
+    if ((files = calloc(numPaths, sizeof(analysisFile))) == NULL)
+    {
+        fprintf(stderr, "Error, Out of Memory for %d Files\n", numPaths);
+        for (i = g_options.numInputs; i < numPaths; i++) {
+            free((char*)paths[i]);
+        }
+        free(paths);
+        return EXIT_FAILURE;
+    }
+    pool.numWorkers = numThreads;
+    for (t = 0; t < numThreads; t++)
+    {
+        pthread_mutex_init(&pool.deques[t].lock, NULL);
+        pool.workers[t].pool  = &pool;
+        pool.workers[t].index = t;
+    }
+    atomic_store(&pool.pending, numPaths);
+    for (i = 0; i < numPaths; i++)
+    {
+        files[i].path = paths[i];
+        pthread_mutex_init(&files[i].lock, NULL);
+        task.file  = &files[i];
+        task.start = 0;
+        task.end   = -1;
+        if (!pushTask(&pool.deques[i % numThreads], task))
+        {
+            snprintf(files[i].error, sizeof(files[i].error), "Out of Memory");
+            atomic_fetch_sub(&pool.pending, 1);
+        }
+    }
+
+    start = getTimeSeconds();
+    for (t = 0; t < numThreads; t++) {
+        pthread_create(&threads[t], NULL, analysisWorkerMain, &pool.workers[t]);
+        pinThread(threads[t], RT_THREAD_ANALYSIS);
+    }
+    for (t = 0; t < numThreads; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    elapsed = getTimeSeconds() - start;
+
+    /* Results */
+    fp = stdout;
+    if (g_options.analyzeOut != NULL && (fp = fopen(g_options.analyzeOut, "w")) == NULL)
+    {
+        fprintf(stderr, "Error, Couldn't Create %s\n", g_options.analyzeOut);
+        fp = stdout;
+    }
+    writeAnalysis(fp, files, numPaths, g_options.analyzeJson);
+    if (fp != stdout) {
+        fclose(fp);
+    }
+
+    for (i = 0; i < numPaths; i++)
+    {
+        if (files[i].error[0] == '\0') {
+            audio += files[i].duration;
+        }
+        else {
+            failed++;
+        }
+        pthread_mutex_destroy(&files[i].lock);
+    }
+    fprintf(stderr, "Analyzed %d Files (%d Failed), %.1f min of Audio in %.1fs on %d Threads (%.0fx Realtime)\n",
+        numPaths, failed, audio / 60.0, elapsed, numThreads, elapsed > 0 ? audio / elapsed : 0);
+
+    for (t = 0; t < numThreads; t++)
+    {
+        free(pool.deques[t].tasks);
+        free(pool.workers[t].buffer);
+        free(pool.workers[t].mono);
+        pthread_mutex_destroy(&pool.deques[t].lock);
+    }
+    for (i = g_options.numInputs; i < numPaths; i++) {
+        free((char*)paths[i]);
+    }
+    free(paths);
+    free(files);
+    return failed == numPaths ? EXIT_FAILURE : EXIT_SUCCESS;
+}